@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <nba/common/compiler.hpp>
+#include <nba/integer.hpp>
+
+#if defined(__AVX2__)
+  #define NBA_COLOR_AVX2
+  #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define NBA_COLOR_SSE2
+  #include <emmintrin.h>
+#endif
+
+namespace nba {
+
+/* Color special effects of the PPU on RGB555 colors.
+ * Green is processed with six bits of precision, bit 15 of the color being the least significant bit.
+ */
+
+enum class ColorEffect : u8 {
+  None,
+  Blend,
+  Brighten,
+  Darken
+};
+
+inline auto BlendRGB555(u16 color_a, u16 color_b, int eva, int evb) -> u16 {
+  const int r_a =  (color_a >>  0) & 31;
+  const int g_a = ((color_a >>  4) & 62) | (color_a >> 15);
+  const int b_a =  (color_a >> 10) & 31;
+
+  const int r_b =  (color_b >>  0) & 31;
+  const int g_b = ((color_b >>  4) & 62) | (color_b >> 15);
+  const int b_b =  (color_b >> 10) & 31;
+
+  eva = std::min<int>(16, eva);
+  evb = std::min<int>(16, evb);
+
+  const int r = std::min<u8>((r_a * eva + r_b * evb + 8) >> 4, 31);
+  const int g = std::min<u8>((g_a * eva + g_b * evb + 8) >> 4, 63) >> 1;
+  const int b = std::min<u8>((b_a * eva + b_b * evb + 8) >> 4, 31);
+
+  return (u16)((b << 10) | (g << 5) | r);
+}
+
+inline auto BrightenRGB555(u16 color, int evy) -> u16 {
+  evy = std::min<int>(16, evy);
+
+  int r =  (color >>  0) & 31;
+  int g = ((color >>  4) & 62) | (color >> 15);
+  int b =  (color >> 10) & 31;
+
+  r += ((31 - r) * evy + 8) >> 4;
+  g += ((63 - g) * evy + 8) >> 4;
+  b += ((31 - b) * evy + 8) >> 4;
+
+  g >>= 1;
+
+  return (u16)((b << 10) | (g << 5) | r);
+}
+
+inline auto DarkenRGB555(u16 color, int evy) -> u16 {
+  evy = std::min<int>(16, evy);
+
+  int r =  (color >>  0) & 31;
+  int g = ((color >>  4) & 62) | (color >> 15);
+  int b =  (color >> 10) & 31;
+
+  r -= (r * evy + 7) >> 4;
+  g -= (g * evy + 7) >> 4;
+  b -= (b * evy + 7) >> 4;
+
+  g >>= 1;
+
+  return (u16)((b << 10) | (g << 5) | r);
+}
+
+ALWAYS_INLINE auto RGB555ToARGB8888(u16 rgb555) -> u32 {
+  const uint r = (rgb555 >>  0) & 31U;
+  const uint g = (rgb555 >>  5) & 31U;
+  const uint b = (rgb555 >> 10) & 31U;
+
+  return 0xFF000000 | (r << 3 | r >> 2) << 16 | (g << 3 | g >> 2) << 8 | (b << 3 | b >> 2);
+}
+
+/* Applies a color effect to each color of a line. The second colors only are read for blended pixels.
+ * Results are bit-identical to the functions for single colors above.
+ */
+inline void ApplyColorEffectsScalar(
+  u16* colors,
+  u16 const* colors_b,
+  ColorEffect const* effects,
+  int count,
+  int eva,
+  int evb,
+  int evy
+) {
+  for(int i = 0; i < count; i++) {
+    switch(effects[i]) {
+      case ColorEffect::None: break;
+      case ColorEffect::Blend: colors[i] = BlendRGB555(colors[i], colors_b[i], eva, evb); break;
+      case ColorEffect::Brighten: colors[i] = BrightenRGB555(colors[i], evy); break;
+      case ColorEffect::Darken: colors[i] = DarkenRGB555(colors[i], evy); break;
+    }
+  }
+}
+
+inline void ConvertRGB555ToARGB8888Scalar(u32* dst, u16 const* src, int count) {
+  for(int i = 0; i < count; i++) {
+    dst[i] = RGB555ToARGB8888(src[i]);
+  }
+}
+
+namespace detail {
+
+#if defined(NBA_COLOR_AVX2)
+
+struct ColorVector {
+  using Type = __m256i;
+
+  static constexpr int kLanes = 16;
+
+  static auto Load(u16 const* src) -> Type { return _mm256_loadu_si256((__m256i const*)src); }
+  static auto LoadU8(void const* src) -> Type { return _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i const*)src)); }
+  static void Store(u16* dst, Type a) { _mm256_storeu_si256((__m256i*)dst, a); }
+  static auto Set(int a) -> Type { return _mm256_set1_epi16((short)a); }
+  static auto And(Type a, Type b) -> Type { return _mm256_and_si256(a, b); }
+  static auto Or(Type a, Type b) -> Type { return _mm256_or_si256(a, b); }
+  static auto Add(Type a, Type b) -> Type { return _mm256_add_epi16(a, b); }
+  static auto Sub(Type a, Type b) -> Type { return _mm256_sub_epi16(a, b); }
+  static auto Mul(Type a, Type b) -> Type { return _mm256_mullo_epi16(a, b); }
+  static auto Min(Type a, Type b) -> Type { return _mm256_min_epi16(a, b); }
+  static auto Equal(Type a, Type b) -> Type { return _mm256_cmpeq_epi16(a, b); }
+  static auto Select(Type mask, Type a, Type b) -> Type { return _mm256_blendv_epi8(b, a, mask); }
+  template<int n> static auto ShiftLeft(Type a) -> Type { return _mm256_slli_epi16(a, n); }
+  template<int n> static auto ShiftRight(Type a) -> Type { return _mm256_srli_epi16(a, n); }
+
+  // Interleaves the low and high halfwords of 16 32-bit values.
+  static void Store(u32* dst, Type lo, Type hi) {
+    // The unpack instructions operate on each 128-bit lane separately.
+    const Type a = _mm256_unpacklo_epi16(lo, hi);
+    const Type b = _mm256_unpackhi_epi16(lo, hi);
+
+    _mm256_storeu_si256((__m256i*)&dst[0], _mm256_permute2x128_si256(a, b, 0x20));
+    _mm256_storeu_si256((__m256i*)&dst[8], _mm256_permute2x128_si256(a, b, 0x31));
+  }
+};
+
+#elif defined(NBA_COLOR_SSE2)
+
+struct ColorVector {
+  using Type = __m128i;
+
+  static constexpr int kLanes = 8;
+
+  static auto Load(u16 const* src) -> Type { return _mm_loadu_si128((__m128i const*)src); }
+  static auto LoadU8(void const* src) -> Type { return _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i const*)src), _mm_setzero_si128()); }
+  static void Store(u16* dst, Type a) { _mm_storeu_si128((__m128i*)dst, a); }
+  static auto Set(int a) -> Type { return _mm_set1_epi16((short)a); }
+  static auto And(Type a, Type b) -> Type { return _mm_and_si128(a, b); }
+  static auto Or(Type a, Type b) -> Type { return _mm_or_si128(a, b); }
+  static auto Add(Type a, Type b) -> Type { return _mm_add_epi16(a, b); }
+  static auto Sub(Type a, Type b) -> Type { return _mm_sub_epi16(a, b); }
+  static auto Mul(Type a, Type b) -> Type { return _mm_mullo_epi16(a, b); }
+  static auto Min(Type a, Type b) -> Type { return _mm_min_epi16(a, b); }
+  static auto Equal(Type a, Type b) -> Type { return _mm_cmpeq_epi16(a, b); }
+  static auto Select(Type mask, Type a, Type b) -> Type { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+  template<int n> static auto ShiftLeft(Type a) -> Type { return _mm_slli_epi16(a, n); }
+  template<int n> static auto ShiftRight(Type a) -> Type { return _mm_srli_epi16(a, n); }
+
+  // Interleaves the low and high halfwords of 8 32-bit values.
+  static void Store(u32* dst, Type lo, Type hi) {
+    _mm_storeu_si128((__m128i*)&dst[0], _mm_unpacklo_epi16(lo, hi));
+    _mm_storeu_si128((__m128i*)&dst[4], _mm_unpackhi_epi16(lo, hi));
+  }
+};
+
+#endif
+
+} // namespace nba::detail
+
+/* Vectorized versions of the above, processing 8 (SSE2) or 16 (AVX2) colors at once.
+ * Every effect is computed for every color and the results are selected afterwards.
+ */
+inline void ApplyColorEffects(
+  u16* colors,
+  u16 const* colors_b,
+  ColorEffect const* effects,
+  int count,
+  int eva,
+  int evb,
+  int evy
+) {
+  int i = 0;
+
+#if defined(NBA_COLOR_AVX2) || defined(NBA_COLOR_SSE2)
+  using V = detail::ColorVector;
+
+  const auto vec_eva = V::Set(std::min<int>(16, eva));
+  const auto vec_evb = V::Set(std::min<int>(16, evb));
+  const auto vec_evy = V::Set(std::min<int>(16, evy));
+
+  const auto vec_7  = V::Set(7);
+  const auto vec_8  = V::Set(8);
+  const auto vec_31 = V::Set(31);
+  const auto vec_62 = V::Set(62);
+  const auto vec_63 = V::Set(63);
+
+  const auto R = [&](V::Type color) { return V::And(color, vec_31); };
+  const auto G = [&](V::Type color) { return V::Or(V::And(V::ShiftRight<4>(color), vec_62), V::ShiftRight<15>(color)); };
+  const auto B = [&](V::Type color) { return V::And(V::ShiftRight<10>(color), vec_31); };
+
+  // Expects six bits of green.
+  const auto Pack = [&](V::Type r, V::Type g, V::Type b) {
+    return V::Or(V::Or(V::ShiftLeft<10>(b), V::ShiftLeft<5>(V::ShiftRight<1>(g))), r);
+  };
+
+  for(; i + V::kLanes <= count; i += V::kLanes) {
+    const auto color_a = V::Load(&colors[i]);
+    const auto color_b = V::Load(&colors_b[i]);
+    const auto effect = V::LoadU8(&effects[i]);
+
+    const auto r_a = R(color_a);
+    const auto g_a = G(color_a);
+    const auto b_a = B(color_a);
+
+    const auto Blend = [&](V::Type a, V::Type b, V::Type max) {
+      return V::Min(V::ShiftRight<4>(V::Add(V::Add(V::Mul(a, vec_eva), V::Mul(b, vec_evb)), vec_8)), max);
+    };
+
+    const auto blend = Pack(
+      Blend(r_a, R(color_b), vec_31),
+      Blend(g_a, G(color_b), vec_63),
+      Blend(b_a, B(color_b), vec_31)
+    );
+
+    const auto Brighten = [&](V::Type a, V::Type max) {
+      return V::Add(a, V::ShiftRight<4>(V::Add(V::Mul(V::Sub(max, a), vec_evy), vec_8)));
+    };
+
+    const auto brighten = Pack(Brighten(r_a, vec_31), Brighten(g_a, vec_63), Brighten(b_a, vec_31));
+
+    const auto Darken = [&](V::Type a) {
+      return V::Sub(a, V::ShiftRight<4>(V::Add(V::Mul(a, vec_evy), vec_7)));
+    };
+
+    const auto darken = Pack(Darken(r_a), Darken(g_a), Darken(b_a));
+
+    auto result = color_a;
+
+    result = V::Select(V::Equal(effect, V::Set((int)ColorEffect::Blend)), blend, result);
+    result = V::Select(V::Equal(effect, V::Set((int)ColorEffect::Brighten)), brighten, result);
+    result = V::Select(V::Equal(effect, V::Set((int)ColorEffect::Darken)), darken, result);
+
+    V::Store(&colors[i], result);
+  }
+#endif
+
+  ApplyColorEffectsScalar(&colors[i], &colors_b[i], &effects[i], count - i, eva, evb, evy);
+}
+
+inline void ConvertRGB555ToARGB8888(u32* dst, u16 const* src, int count) {
+  int i = 0;
+
+#if defined(NBA_COLOR_AVX2) || defined(NBA_COLOR_SSE2)
+  using V = detail::ColorVector;
+
+  const auto vec_31 = V::Set(31);
+  const auto vec_alpha = V::Set(0xFF00);
+
+  // Expands a five bit color channel to eight bits.
+  const auto Expand = [&](V::Type a) {
+    return V::Or(V::ShiftLeft<3>(a), V::ShiftRight<2>(a));
+  };
+
+  for(; i + V::kLanes <= count; i += V::kLanes) {
+    const auto color = V::Load(&src[i]);
+
+    const auto r = Expand(V::And(color, vec_31));
+    const auto g = Expand(V::And(V::ShiftRight<5>(color), vec_31));
+    const auto b = Expand(V::And(V::ShiftRight<10>(color), vec_31));
+
+    V::Store(&dst[i], V::Or(V::ShiftLeft<8>(g), b), V::Or(vec_alpha, r));
+  }
+#endif
+
+  ConvertRGB555ToARGB8888Scalar(&dst[i], &src[i], count - i);
+}
+
+} // namespace nba
@@ -25,4 +25,25 @@
   #define unreachable() __assume(0)
 #else
   #define unreachable()
+#endif
+
+#if defined(__clang) || defined(__GNUC__)
+  #define count_trailing_zeros64(x) __builtin_ctzll(x)
+#elif defined(_MSC_VER)
+  #include <intrin.h>
+
+  inline int count_trailing_zeros64(unsigned long long x) {
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (int)index;
+  }
+#else
+  inline int count_trailing_zeros64(unsigned long long x) {
+    int count = 0;
+    while((x & 1U) == 0U) {
+      x >>= 1;
+      count++;
+    }
+    return count;
+  }
 #endif
\ No newline at end of file
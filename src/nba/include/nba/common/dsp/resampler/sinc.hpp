@@ -7,90 +7,186 @@
 
 #pragma once
 
+#include <memory>
 #include <nba/common/dsp/resampler.hpp>
-#include <nba/common/dsp/ring_buffer.hpp>
+#include <type_traits>
+
+#if defined(__AVX2__)
+  #define NBA_SINC_AVX2
+  #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define NBA_SINC_SSE2
+  #include <emmintrin.h>
+#endif
 
 namespace nba {
 
-template<typename T, int points>
-struct SincResampler : Resampler<T> {
-  static_assert((points % 4) == 0, "SincResampler<T, points>: points must be divisible by four.");
+// Computes the dot products of the coefficients with the left and the right taps.
+inline void SincDotProductScalar(
+  float const* coeffs,
+  float const* taps_l,
+  float const* taps_r,
+  int length,
+  float& out_l,
+  float& out_r
+) {
+  float sum_l = 0;
+  float sum_r = 0;
+
+  for(int i = 0; i < length; i++) {
+    sum_l += coeffs[i] * taps_l[i];
+    sum_r += coeffs[i] * taps_r[i];
+  }
 
-  SincResampler(std::shared_ptr<WriteStream<T>> output) 
-      : Resampler<T>(output) {
-    SetSampleRates(1, 1);
+  out_l = sum_l;
+  out_r = sum_r;
+}
 
-    for(int i = 0; i < points - 1; i++) {
-      taps.Write({});
+/* Vectorized version of the above, the length must be divisible by 16.
+ * Two accumulators are used per channel, so that consecutive additions do not depend on each other.
+ */
+inline void SincDotProduct(
+  float const* coeffs,
+  float const* taps_l,
+  float const* taps_r,
+  int length,
+  float& out_l,
+  float& out_r
+) {
+#if defined(NBA_SINC_AVX2)
+  __m256 sum_l[2] { _mm256_setzero_ps(), _mm256_setzero_ps() };
+  __m256 sum_r[2] { _mm256_setzero_ps(), _mm256_setzero_ps() };
+
+  for(int i = 0; i < length; i += 16) {
+    for(int j = 0; j < 2; j++) {
+      const __m256 coeff = _mm256_loadu_ps(&coeffs[i + j * 8]);
+
+      sum_l[j] = _mm256_add_ps(sum_l[j], _mm256_mul_ps(coeff, _mm256_loadu_ps(&taps_l[i + j * 8])));
+      sum_r[j] = _mm256_add_ps(sum_r[j], _mm256_mul_ps(coeff, _mm256_loadu_ps(&taps_r[i + j * 8])));
     }
   }
-  
+
+  // (l0+l1, l2+l3, r0+r1, r2+r3) in each 128-bit lane
+  const __m256 sum_lr = _mm256_hadd_ps(_mm256_add_ps(sum_l[0], sum_l[1]), _mm256_add_ps(sum_r[0], sum_r[1]));
+
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(sum_lr), _mm256_extractf128_ps(sum_lr, 1));
+
+  sum = _mm_hadd_ps(sum, sum);
+
+  out_l = _mm_cvtss_f32(sum);
+  out_r = _mm_cvtss_f32(_mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+#elif defined(NBA_SINC_SSE2)
+  __m128 sum_l[2] { _mm_setzero_ps(), _mm_setzero_ps() };
+  __m128 sum_r[2] { _mm_setzero_ps(), _mm_setzero_ps() };
+
+  for(int i = 0; i < length; i += 8) {
+    for(int j = 0; j < 2; j++) {
+      const __m128 coeff = _mm_loadu_ps(&coeffs[i + j * 4]);
+
+      sum_l[j] = _mm_add_ps(sum_l[j], _mm_mul_ps(coeff, _mm_loadu_ps(&taps_l[i + j * 4])));
+      sum_r[j] = _mm_add_ps(sum_r[j], _mm_mul_ps(coeff, _mm_loadu_ps(&taps_r[i + j * 4])));
+    }
+  }
+
+  const __m128 l = _mm_add_ps(sum_l[0], sum_l[1]);
+  const __m128 r = _mm_add_ps(sum_r[0], sum_r[1]);
+
+  // (l0+l2, r0+r2, l1+l3, r1+r3)
+  __m128 sum = _mm_add_ps(_mm_unpacklo_ps(l, r), _mm_unpackhi_ps(l, r));
+
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+
+  out_l = _mm_cvtss_f32(sum);
+  out_r = _mm_cvtss_f32(_mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+#else
+  SincDotProductScalar(coeffs, taps_l, taps_r, length, out_l, out_r);
+#endif
+}
+
+/* Polyphase windowed sinc resampler.
+ * The coefficients of each phase are stored next to each other, and each tap is stored twice,
+ * so that the coefficients and the last taps can be read from contiguous memory without wrapping around.
+ */
+template<typename T, int points>
+struct SincStereoResampler : StereoResampler<T> {
+  static_assert(std::is_same_v<T, float>, "SincStereoResampler<T, points>: T must be float.");
+  static_assert((points % 16) == 0, "SincStereoResampler<T, points>: points must be divisible by 16.");
+
+  SincStereoResampler(std::shared_ptr<WriteStream<StereoSample<T>>> output)
+      : StereoResampler<T>(output) {
+    lut = std::make_unique<float[]>(points * s_lut_resolution);
+
+    SetSampleRates(1, 1);
+  }
+
   void SetSampleRates(float samplerate_in, float samplerate_out) final {
-    Resampler<T>::SetSampleRates(samplerate_in, samplerate_out);
-    
-    float kernelSum = 0.0;
-    float cutoff = 0.9;
-    
+    StereoResampler<T>::SetSampleRates(samplerate_in, samplerate_out);
+
+    double cutoff = 0.9;
+
     if(this->resample_phase_shift > 1.0) {
       cutoff /= this->resample_phase_shift;
     }
 
-    for(int n = 0; n < points; n++) {
-      for(int m = 0; m < s_lut_resolution; m++) {
-        double t  = m/double(s_lut_resolution);
-        double x1 = M_PI * (t - n + points/2) + 1e-6;
-        double x2 = 2 * M_PI * (n + t)/points; 
-        double sinc = std::sin(cutoff * x1)/x1;
-        double blackman = 0.42 - 0.49 * std::cos(x2) + 0.076 * std::cos(2 * x2);
-        
-        lut[n * s_lut_resolution + m] = sinc * blackman;
-        kernelSum += sinc * blackman;
+    const auto Kernel = [&](int n, int m) {
+      double t  = m/double(s_lut_resolution);
+      double x1 = M_PI * (t - n + points/2) + 1e-6;
+      double x2 = 2 * M_PI * (n + t)/points;
+      double sinc = std::sin(cutoff * x1)/x1;
+      double blackman = 0.42 - 0.49 * std::cos(x2) + 0.076 * std::cos(2 * x2);
+
+      return sinc * blackman;
+    };
+
+    double kernel_sum = 0.0;
+
+    for(int m = 0; m < s_lut_resolution; m++) {
+      for(int n = 0; n < points; n++) {
+        kernel_sum += Kernel(n, m);
       }
     }
-    
-    kernelSum /= s_lut_resolution;
-    
-    for(int i = 0; i < points * s_lut_resolution; i++) {
-      lut[i] /= kernelSum;
+
+    kernel_sum /= s_lut_resolution;
+
+    for(int m = 0; m < s_lut_resolution; m++) {
+      for(int n = 0; n < points; n++) {
+        lut[m * points + n] = (float)(Kernel(n, m) / kernel_sum);
+      }
     }
   }
 
-  void Write(T const& input) final {
-    taps.Write(input);
-
-    while(resample_phase < 1.0) { 
-      T sample = {};
-
-      int x = (int)(resample_phase * s_lut_resolution);
-      
-      for(int n = 0; n < points; n += 4) {        
-        sample += taps.Peek(n + 0) * lut[x + 0 * s_lut_resolution];
-        sample += taps.Peek(n + 1) * lut[x + 1 * s_lut_resolution]; 
-        sample += taps.Peek(n + 2) * lut[x + 2 * s_lut_resolution]; 
-        sample += taps.Peek(n + 3) * lut[x + 3 * s_lut_resolution];
-        
-        x += 4 * s_lut_resolution;
-      }
+  void Write(StereoSample<T> const& input) final {
+    // The oldest tap is replaced, after that taps_index points to the oldest of the remaining taps.
+    taps_l[taps_index] = taps_l[taps_index + points] = input.left;
+    taps_r[taps_index] = taps_r[taps_index + points] = input.right;
+
+    if(++taps_index == points) {
+      taps_index = 0;
+    }
+
+    while(resample_phase < 1.0) {
+      StereoSample<T> sample;
+
+      const float* coeffs = &lut[(int)(resample_phase * s_lut_resolution) * points];
+
+      SincDotProduct(coeffs, &taps_l[taps_index], &taps_r[taps_index], points, sample.left, sample.right);
 
       this->output->Write(sample);
 
       resample_phase += this->resample_phase_shift;
     }
 
-    taps.Read();
-
     resample_phase = resample_phase - 1.0;
   }
-  
+
 private:
   static constexpr int s_lut_resolution = 512;
 
-  double lut[points * s_lut_resolution];
+  std::unique_ptr<float[]> lut;
   float resample_phase = 0;
-  RingBuffer<T> taps { points };
+  float taps_l[points * 2] {};
+  float taps_r[points * 2] {};
+  int taps_index = 0;
 };
 
-template <typename T, int points>
-using SincStereoResampler = SincResampler<StereoSample<T>, points>;
-
 } // namespace nba
@@ -18,6 +18,33 @@ namespace nba {
 struct Config {
   bool skip_bios = false;
 
+  // Fast-forward loops which only poll hardware state until the next hardware event.
+  bool skip_idle_loops = true;
+
+  // Execute common BIOS functions natively. Without a BIOS file a minimal replacement BIOS is used.
+  bool hle_bios = false;
+
+  /* Draw each scanline in one go at the start of H-blank instead of emulating the PPU cycle by cycle.
+   * Changes to the PPU state in the middle of a scanline are not visible and the CPU never
+   * has to wait for the PPU to access VRAM, PRAM or OAM.
+   */
+  bool scanline_renderer = false;
+
+  /* Draw the scanlines of the scanline renderer on a separate thread, which runs behind the emulation.
+   * The emulation thread only records the PPU state of each scanline. Frames are bit-identical to those of the
+   * single-threaded scanline renderer. The only difference in emulation is that the CPU never waits for
+   * BG VRAM fetches, which the single-threaded scanline renderer emulates for text BGs that fetch beyond BG VRAM.
+   * Has no effect unless the scanline renderer is enabled.
+   */
+  bool threaded_renderer = false;
+
+  /* Number of frames that are skipped after each frame that is drawn, for example while fast-forwarding.
+   * Skipped frames are emulated as usual, including the PPU's memory access timing, but their pixels are
+   * not composed and they are not passed to the video device. The BG VRAM fetch latch, which is used for BGs
+   * that fetch beyond BG VRAM, is only kept up to date by the last scanline of a skipped frame.
+   */
+  int frame_skip = 0;
+
   enum class BackupType {
     Detect,
     None,
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <nba/rom/gpio/rtc.hpp>
 #include <nba/rom/gpio/solar_sensor.hpp>
@@ -36,6 +37,8 @@ enum class Key : u8 {
 struct CoreBase {
   static constexpr int kCyclesPerFrame = 280896;
 
+  using PCHook = std::function<void(u32 address)>;
+
   virtual ~CoreBase() = default;
 
   virtual void Reset() = 0;
@@ -49,6 +52,14 @@ struct CoreBase {
   virtual void SetKeyStatus(Key key, bool pressed) = 0;
   virtual void Run(int cycles) = 0;
 
+  /* Calls the hook right before the CPU executes the instruction at the given address,
+   * but only if the CPU got there by a branch, an exception or a return from an exception.
+   * A hook may change the CPU state, but must not add or remove hooks.
+   * Returns a handle which can be passed to RemovePCHook().
+   */
+  virtual auto AddPCHook(u32 address, PCHook hook) -> int = 0;
+  virtual void RemovePCHook(int handle) = 0;
+
   virtual auto GetROM() -> ROM& = 0;
   virtual auto GetPRAM() -> u8* = 0;
   virtual auto GetVRAM() -> u8* = 0;
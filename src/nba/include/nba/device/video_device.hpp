@@ -12,13 +12,24 @@
 namespace nba {
 
 struct VideoDevice {
+  struct FrameInfo {
+    // Number of frames that were drawn since the last reset.
+    u64 number;
+
+    // The emulated time at which the frame was completed, in cycles.
+    u64 timestamp;
+
+    // Set if the frame is identical to the previous frame, so that it does not need to be presented again.
+    bool unchanged;
+  };
+
   virtual ~VideoDevice() = default;
 
-  virtual void Draw(u32* buffer) = 0;
+  virtual void Draw(u32* buffer, FrameInfo const& info) = 0;
 };
 
 struct NullVideoDevice : VideoDevice {
-  void Draw(u32* buffer) final { }
+  void Draw(u32* buffer, FrameInfo const&) final { }
 };
 
 } // namespace nba
@@ -19,6 +19,9 @@ struct Backup {
   virtual auto Read (u32 address) -> u8 = 0;
   virtual void Write(u32 address, u8 value) = 0;
 
+  // Writes pending changes back to the save file.
+  virtual void Flush() = 0;
+
   virtual void LoadState(SaveState const& state) = 0;
   virtual void CopyState(SaveState& state) = 0;
 };
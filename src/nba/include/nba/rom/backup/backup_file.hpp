@@ -21,14 +21,23 @@ namespace fs = std::filesystem;
 
 namespace nba {
 
+/* Keeps the save data in memory and writes it back to the save file on Flush().
+ * The file is replaced atomically by writing to a temporary file, syncing it to disk and renaming it,
+ * so that a crash or power loss during a flush never leaves behind a partially written save file.
+ */
 struct BackupFile {
+ ~BackupFile() {
+    Flush();
+  }
+
   static auto OpenOrCreate(fs::path const& save_path,
                            std::vector<size_t> const& valid_sizes,
                            int& default_size) -> std::unique_ptr<BackupFile> {
     bool create = true;
-    auto flags = std::ios::binary | std::ios::in | std::ios::out;
     std::unique_ptr<BackupFile> file { new BackupFile() };
 
+    file->save_path = save_path;
+
     // @todo: check file type and permissions?
     if(fs::is_regular_file(save_path)) {
       auto file_size = fs::file_size(save_path);
@@ -40,14 +49,15 @@ struct BackupFile {
       auto end = valid_sizes.end();
 
       if(std::find(begin, end, save_size) != end) {
-        file->stream.open(save_path.c_str(), flags);
-        if(file->stream.fail()) {
+        std::ifstream stream{save_path, std::ios::binary};
+        if(stream.fail()) {
           throw std::runtime_error("BackupFile: unable to open file: " + save_path.string());
         }
         default_size = save_size;
         file->save_size = save_size;
+        file->file_size = file_size;
         file->memory.reset(new u8[file_size]);
-        file->stream.read((char*)file->memory.get(), file_size);
+        stream.read((char*)file->memory.get(), file_size);
         create = false;
       }
     }
@@ -57,12 +67,12 @@ struct BackupFile {
      */
     if(create) {
       file->save_size = default_size;
-      file->stream.open(save_path, flags | std::ios::trunc);
-      if(file->stream.fail()) {
-        throw std::runtime_error("BackupFile: unable to create file: " + save_path.string());
-      }
+      file->file_size = default_size;
       file->memory.reset(new u8[default_size]);
       file->MemorySet(0, default_size, 0xFF);
+      if(!file->Flush()) {
+        throw std::runtime_error("BackupFile: unable to create file: " + save_path.string());
+      }
     }
 
     return file;
@@ -80,9 +90,7 @@ struct BackupFile {
       throw std::runtime_error("BackupFile: out-of-bounds index while writing.");
     }
     memory[index] = value;
-    if(auto_update) {
-      Update(index, 1);
-    }
+    dirty = true;
   }
 
   void MemorySet(unsigned index, size_t length, u8 value) {
@@ -90,19 +98,20 @@ struct BackupFile {
       throw std::runtime_error("BackupFile: out-of-bounds index while setting memory.");
     }
     std::memset(&memory[index], value, length);
-    if(auto_update) {
-      Update(index, length);
-    }
+    dirty = true;
   }
 
-  void Update(unsigned index, size_t length) {
+  void MemoryCopy(unsigned index, u8 const* data, size_t length) {
     if((index + length) > save_size) {
-      throw std::runtime_error("BackupFile: out-of-bounds index while updating file.");
+      throw std::runtime_error("BackupFile: out-of-bounds index while copying memory.");
     }
-    stream.seekg(index);
-    stream.write((char*)&memory[index], length);
+    std::memcpy(&memory[index], data, length);
+    dirty = true;
   }
 
+  // Writes the save data back to the file, if it changed. Returns false if the file could not be written.
+  bool Flush();
+
   auto Buffer() -> u8* {
     return memory.get();
   }
@@ -111,13 +120,14 @@ struct BackupFile {
     return save_size;
   }
 
-  bool auto_update = true;
-
 private:
   BackupFile() { }
 
+  fs::path save_path;
   size_t save_size;
-  std::fstream stream;
+  size_t file_size;
+  bool dirty = false;
+  bool flush_failed = false;
   std::unique_ptr<u8[]> memory;
 };
 
@@ -26,6 +26,7 @@ struct EEPROM : Backup {
   void Reset() final;
   auto Read (u32 address) -> u8 final;
   void Write(u32 address, u8 value) final;
+  void Flush() final;
   
   void LoadState(SaveState const& state) final;
   void CopyState(SaveState& state) final;
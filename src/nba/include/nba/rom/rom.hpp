@@ -113,6 +113,16 @@ struct ROM {
     }
   }
 
+  void FlushBackup() {
+    if(backup_sram) {
+      backup_sram->Flush();
+    }
+
+    if(backup_eeprom) {
+      backup_eeprom->Flush();
+    }
+  }
+
   void SetEEPROMSizeHint(EEPROM::Size size) {
     if(backup_eeprom) {
       ((EEPROM*)backup_eeprom.get())->SetSizeHint(size);
@@ -180,6 +190,27 @@ struct ROM {
     return data;
   }
 
+  /* Returns the data that a sequential burst of reads starting at the given address would return,
+   * as long as the burst only reads plain ROM data which directly follows the latched address.
+   * In that case the address latch is advanced past the end of the burst, otherwise nullptr is returned.
+   */
+  auto GetSequentialData(u32 address, u32 size) -> u8 const* {
+    address &= 0x01FF'FFFE;
+
+    const u32 address_end = address + size;
+
+    if(rom_address_latch != address || address_end > rom.size() || address_end > rom_mask + 1) {
+      return nullptr;
+    }
+
+    if((gpio && address <= 0xC8 && address_end > 0xC4) || (backup_eeprom && address_end > eeprom_mask)) {
+      return nullptr;
+    }
+
+    rom_address_latch = address_end & rom_mask;
+    return &rom[address];
+  }
+
   void ALWAYS_INLINE WriteROM(u32 address, u16 value, bool sequential) {
     address &= 0x01FF'FFFE;
 
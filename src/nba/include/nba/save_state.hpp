@@ -16,7 +16,7 @@ namespace nba {
 
 struct SaveState {
   static constexpr u32 kMagicNumber = 0x5353424E; // NBSS
-  static constexpr u32 kCurrentVersion = 10;
+  static constexpr u32 kCurrentVersion = 11;
 
   u32 magic;
   u32 version;
@@ -11,18 +11,12 @@
 #include <nba/common/compiler.hpp>
 #include <nba/integer.hpp>
 #include <nba/save_state.hpp>
-#include <functional>
 #include <limits>
+#include <type_traits>
 
 namespace nba::core {
 
 struct Scheduler {
-  template<class T>
-  using EventMethod = void (T::*)();
-
-  template<class T>
-  using EventMethodWithUserData = void (T::*)(u64);
-
   enum class EventClass : u16 {
     // ARM
     ARM_ldm_usermode_conflict,
@@ -75,6 +69,7 @@ struct Scheduler {
     u64 timestamp; 
 
     u64 UID() const { return uid; }
+    u64 UserData() const { return user_data; }
   
   private:
     friend class Scheduler;
@@ -83,29 +78,29 @@ struct Scheduler {
     u64 uid;
     u64 user_data;
     EventClass event_class;
+
+    // Links (event slot numbers) in the list of pending events of the same class
+    s8 prev_in_bucket;
+    s8 next_in_bucket;
   };
 
   Scheduler() {
-    Register(EventClass::EndOfQueue, this, &Scheduler::EndOfQueue);
-
+    /* All events live in one contiguous array and the heap only stores pointers into it.
+     * Heap entries past the end of the heap always reference the unused event slots.
+     * Adding an event takes the slot at heap_size, removing an event parks its slot there.
+     */
     for(int i = 0; i < kMaxEvents; i++) {
-      heap[i] = new Event();
-      heap[i]->handle = i;
+      heap[i] = &events[i];
+      events[i].handle = i;
     }
 
     for(int i = 0; i < (int)EventClass::Count; i++) {
-      callbacks[i] = [i](u64 user_data) {
-        Assert(false, "Scheduler: unhandled event class: {}", i);
-      };
+      callbacks[i] = {this, &Scheduler::UnhandledEvent};
     }
 
-    Reset();
-  }
+    Register<&Scheduler::EndOfQueue>(EventClass::EndOfQueue, this);
 
- ~Scheduler() {
-    for(int i = 0; i < kMaxEvents; i++) {
-      delete heap[i];
-    }
+    Reset();
   }
 
   void Reset() {
@@ -113,6 +108,10 @@ struct Scheduler {
     timestamp_now = 0;
     next_uid = 1;
 
+    for(auto& head : events_by_class) {
+      head = kNoEvent;
+    }
+
     Add(std::numeric_limits<u64>::max(), EventClass::EndOfQueue);
   }
 
@@ -138,52 +137,16 @@ struct Scheduler {
     timestamp_now = timestamp_next;
   }
 
-  template<class T>
-  void Register(EventClass event_class, T* object, EventMethod<T> method, uint priority = 0) {
-    callbacks[(int)event_class] = [object, method](u64 user_data) {
-      (object->*method)();
-    };
-  }
-
-  template<class T>
-  void Register(EventClass event_class, T* object, EventMethodWithUserData<T> method, uint priority = 0) {
-    callbacks[(int)event_class] = [object, method](u64 user_data) {
-      (object->*method)(user_data);
-    };
+  /* The method is passed as a template argument, so that it can be baked into
+   * a trampoline function. Dispatching an event then only costs a single indirect call.
+   */
+  template<auto method, class T>
+  void Register(EventClass event_class, T* object) {
+    callbacks[(int)event_class] = {object, &Trampoline<T, method>};
   }
 
   auto Add(u64 delay, EventClass event_class, uint priority = 0, u64 user_data = 0) -> Event* {
-    int n = heap_size++;
-    int p = Parent(n);
-
-    Assert(
-      heap_size <= kMaxEvents,
-      "Scheduler: reached maximum number of events."
-    );
-
-    Assert(priority <= 3, "Scheduler: priority must be between 0 and 3.");
-
-    auto event = heap[n];
-    event->timestamp = GetTimestampNow() + delay;
-    event->key = (event->timestamp << 2) | priority;
-    event->uid = next_uid++;
-    event->user_data = user_data;
-    event->event_class = event_class;
-
-    while(n != 0 && heap[p]->key > heap[n]->key) {
-      Swap(n, p);
-      n = p;
-      p = Parent(n);
-    }
-
-    return event;
-  }
-
-  template<class T>
-  auto Add(u64 delay, T* object, EventMethod<T> method, uint priority = 0) -> Event* {
-    return Add(delay, [object, method](int cycles_late) {
-      (object->*method)(cycles_late);
-    }, priority);
+    return Add(delay, event_class, priority, user_data, (next_uid++ << kUIDClassBits) | (u64)event_class);
   }
 
   void Cancel(Event* event) {
@@ -191,17 +154,30 @@ struct Scheduler {
   }
 
   auto GetEventByUID(u64 uid) -> Event* {
-    for(int i = 0; i < heap_size; i++) {
-      auto event = heap[i];
+    int slot = events_by_class[uid & kUIDClassMask];
 
-      if(event->uid == uid) {
-        return event;
+    while(slot != kNoEvent) {
+      if(events[slot].uid == uid) {
+        return &events[slot];
       }
+      slot = events[slot].next_in_bucket;
     }
 
     return nullptr;
   }
 
+  // Calls the functor for each pending event of the given class.
+  template<typename Functor>
+  void ForEachEvent(EventClass event_class, Functor&& functor) {
+    int slot = events_by_class[(int)event_class];
+
+    while(slot != kNoEvent) {
+      int next = events[slot].next_in_bucket;
+      functor(&events[slot]);
+      slot = next;
+    }
+  }
+
   void LoadState(SaveState const& state) {
     auto& ss_scheduler = state.scheduler;
 
@@ -219,10 +195,9 @@ struct Scheduler {
         continue;
       }
 
-      Add(timestamp - state.timestamp, event_class, priority, user_data)->uid = uid;
+      Add(timestamp - state.timestamp, event_class, priority, user_data, uid);
     }
 
-    // This must happen after deserializing all events, because calling Add() modifies `next_uid`.
     next_uid = ss_scheduler.next_uid;
   }
 
@@ -241,68 +216,174 @@ struct Scheduler {
 
 private:
   static constexpr int kMaxEvents = 64;
+  static constexpr s8 kNoEvent = -1;
+
+  /* The low bits of a UID hold the event class, so the events are indexed by UID and by class with the same lists.
+   * GetEventByUID() only has to search the (few) pending events of one class.
+   */
+  static constexpr int kUIDClassBits = 5;
+  static constexpr int kUIDClassMask = (1 << kUIDClassBits) - 1;
+
+  static_assert((int)EventClass::Count <= (1 << kUIDClassBits), "Scheduler: event class does not fit into the UID.");
 
   static constexpr int Parent(int n) { return (n - 1) / 2; }
   static constexpr int LeftChild(int n) { return n * 2 + 1; }
   static constexpr int RightChild(int n) { return n * 2 + 2; }
 
+  auto Add(u64 delay, EventClass event_class, uint priority, u64 user_data, u64 uid) -> Event* {
+    int n = heap_size++;
+
+    Assert(
+      heap_size <= kMaxEvents,
+      "Scheduler: reached maximum number of events."
+    );
+
+    Assert(priority <= 3, "Scheduler: priority must be between 0 and 3.");
+
+    auto event = heap[n];
+    event->timestamp = GetTimestampNow() + delay;
+    event->key = (event->timestamp << 2) | priority;
+    event->uid = uid;
+    event->user_data = user_data;
+    event->event_class = event_class;
+
+    SiftUp(n, event);
+    Link(event);
+
+    return event;
+  }
+
   void Step(u64 timestamp_next) {
-    while(heap[0]->timestamp <= timestamp_next && heap_size > 0) {
+    while(heap_size > 0 && heap[0]->timestamp <= timestamp_next) {
       auto event = heap[0];
       timestamp_now = event->timestamp;
-      callbacks[(int)event->event_class](event->user_data);
+      auto& callback = callbacks[(int)event->event_class];
+      callback.function(callback.object, event->user_data);
       Remove(event->handle);
     }
   }
 
   void Remove(int n) {
-    Swap(n, --heap_size);
-
-    int p = Parent(n);
-    if(n != 0 && heap[p]->key > heap[n]->key) {
-      do {
-        Swap(n, p);
-        n = p;
-        p = Parent(n);
-      } while(n != 0 && heap[p]->key > heap[n]->key);
-    } else {
-      Heapify(n);
+    int last = --heap_size;
+
+    Unlink(heap[n]);
+
+    if(n != last) {
+      auto entry = heap[last];
+
+      // Park the now unused event slot past the end of the heap.
+      Move(last, heap[n]);
+
+      if(n != 0 && heap[Parent(n)]->key > entry->key) {
+        SiftUp(n, entry);
+      } else {
+        SiftDown(n, entry);
+      }
     }
   }
 
-  void Swap(int i, int j) {
-    auto tmp = heap[i];
-    heap[i] = heap[j];
-    heap[j] = tmp;
-    heap[i]->handle = i;
-    heap[j]->handle = j;
+  void Move(int n, Event* entry) {
+    heap[n] = entry;
+    entry->handle = n;
+  }
+
+  void Link(Event* event) {
+    int slot = int(event - events);
+    s8& head = events_by_class[(int)event->event_class];
+
+    event->prev_in_bucket = kNoEvent;
+    event->next_in_bucket = head;
+    if(head != kNoEvent) {
+      events[head].prev_in_bucket = (s8)slot;
+    }
+    head = (s8)slot;
   }
 
-  void Heapify(int n) {
-    int l = LeftChild(n);
-    int r = RightChild(n);
+  void Unlink(Event* event) {
+    int prev_slot = event->prev_in_bucket;
+    int next_slot = event->next_in_bucket;
 
-    if(l < heap_size && heap[l]->key < heap[n]->key) {
-      Swap(l, n);
-      Heapify(l);
+    if(prev_slot != kNoEvent) {
+      events[prev_slot].next_in_bucket = (s8)next_slot;
+    } else {
+      events_by_class[(int)event->event_class] = (s8)next_slot;
     }
 
-    if(r < heap_size && heap[r]->key < heap[n]->key) {
-      Swap(r, n);
-      Heapify(r);
+    if(next_slot != kNoEvent) {
+      events[next_slot].prev_in_bucket = (s8)prev_slot;
     }
   }
 
+  void SiftUp(int n, Event* entry) {
+    while(n != 0) {
+      int p = Parent(n);
+
+      if(heap[p]->key <= entry->key) {
+        break;
+      }
+
+      Move(n, heap[p]);
+      n = p;
+    }
+
+    Move(n, entry);
+  }
+
+  void SiftDown(int n, Event* entry) {
+    while(true) {
+      int l = LeftChild(n);
+      int r = RightChild(n);
+
+      if(l >= heap_size) {
+        break;
+      }
+
+      int c = (r < heap_size && heap[r]->key < heap[l]->key) ? r : l;
+
+      if(heap[c]->key >= entry->key) {
+        break;
+      }
+
+      Move(n, heap[c]);
+      n = c;
+    }
+
+    Move(n, entry);
+  }
+
   void EndOfQueue() {
     Assert(false, "Scheduler: reached end of the event queue.");
   }
 
+  template<class T, auto method>
+  static void Trampoline(void* object, u64 user_data) {
+    if constexpr(std::is_invocable_v<decltype(method), T*, u64>) {
+      (static_cast<T*>(object)->*method)(user_data);
+    } else {
+      (static_cast<T*>(object)->*method)();
+    }
+  }
+
+  static void UnhandledEvent(void* object, u64) {
+    // The event which is being dispatched always is at the top of the heap.
+    auto scheduler = static_cast<Scheduler*>(object);
+
+    Assert(false, "Scheduler: unhandled event class: {}", (int)scheduler->heap[0]->event_class);
+  }
+
+  struct Callback {
+    void* object;
+    void (*function)(void* object, u64 user_data);
+  };
+
+  Event events[kMaxEvents];
   Event* heap[kMaxEvents];
+  s8 events_by_class[1 << kUIDClassBits];
   int heap_size;
   u64 timestamp_now;
   u64 next_uid;
 
-  std::function<void(u64)> callbacks[(int)EventClass::Count];
+  Callback callbacks[(int)EventClass::Count];
 };
 
 inline u64 GetEventUID(Scheduler::Event* event) {
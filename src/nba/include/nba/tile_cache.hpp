@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <nba/common/compiler.hpp>
+#include <nba/common/punning.hpp>
+#include <nba/integer.hpp>
+
+namespace nba {
+
+/* Provides the tiles in VRAM with one color index per byte, so that each tile is 8x8 bytes.
+ * 8BPP tiles are stored like that in VRAM already, so only 4BPP tiles need to be decoded.
+ * Writes to VRAM only mark the 4BPP tile they hit as dirty, the tile is decoded when it is read next.
+ * The cache is not thread-safe, code which runs on another thread than the emulation must use a TileCacheSnapshot.
+ */
+struct TileCache {
+  TileCache(u8 const* vram) : vram(vram) {
+    Invalidate(0U, 0x18000U);
+  }
+
+  // Returns the color indices of the 4BPP tile data at the given VRAM offset.
+  auto ALWAYS_INLINE GetTile4BPP(u32 address) -> u8 const* {
+    const u32 tile = address >> 5;
+
+    if(unlikely(dirty[tile >> 6] & (1ULL << (tile & 63)))) {
+      Decode(tile);
+    }
+    return &data_4bpp[address << 1];
+  }
+
+  // Returns the color indices of the 8BPP tile data at the given VRAM offset.
+  auto ALWAYS_INLINE GetTile8BPP(u32 address) const -> u8 const* {
+    return &vram[address];
+  }
+
+  // Marks the 4BPP tile which contains the given VRAM offset as dirty.
+  void ALWAYS_INLINE Invalidate(u32 address) {
+    const u32 tile = address >> 5;
+
+    dirty[tile >> 6] |= 1ULL << (tile & 63);
+  }
+
+  // Marks the 4BPP tiles in [address_min, address_max) as dirty.
+  void Invalidate(u32 address_min, u32 address_max) {
+    for(u32 address = address_min; address < address_max; address += 32U) {
+      Invalidate(address);
+    }
+  }
+
+private:
+  void Decode(u32 tile) {
+    const u32 address = tile << 5;
+
+    for(u32 offset = 0; offset < 32U; offset += sizeof(u32)) {
+      u64 data = read<u32>(vram, address + offset);
+
+      // Move each nibble into its own byte.
+      data = (data | (data << 16)) & 0x0000FFFF0000FFFFULL;
+      data = (data | (data <<  8)) & 0x00FF00FF00FF00FFULL;
+      data = (data | (data <<  4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+      write<u64>(data_4bpp, (address + offset) << 1, data);
+    }
+
+    dirty[tile >> 6] &= ~(1ULL << (tile & 63));
+  }
+
+  u8 const* vram;
+  u8 data_4bpp[0x30000];
+  std::array<u64, 0x18000 / 32 / 64> dirty;
+};
+
+/* A copy of VRAM with its own tile cache.
+ * The debugger viewers run on the UI thread while the emulation writes VRAM and the tile cache of the PPU,
+ * so they read from a snapshot which is only updated when they redraw.
+ */
+struct TileCacheSnapshot {
+  // Copies VRAM and invalidates the tiles in each 1 KiB page which changed since the last update.
+  void Update(u8 const* vram_src) {
+    for(u32 address = 0; address < 0x18000U; address += 0x400U) {
+      if(std::memcmp(&vram[address], &vram_src[address], 0x400U) != 0) {
+        std::memcpy(&vram[address], &vram_src[address], 0x400U);
+        tile_cache.Invalidate(address, address + 0x400U);
+      }
+    }
+  }
+
+  auto GetVRAM() const -> u8 const* {
+    return vram;
+  }
+
+  auto GetTileCache() -> TileCache& {
+    return tile_cache;
+  }
+
+private:
+  u8 vram[0x18000] {};
+  TileCache tile_cache{vram};
+};
+
+} // namespace nba
@@ -14,6 +14,7 @@
 #include <nba/scheduler.hpp>
 
 #include "bus/bus.hpp"
+#include "arm/hook_bitmap.hpp"
 #include "arm/state.hpp"
 
 /**
@@ -32,12 +33,14 @@ struct ARM7TDMI {
   ARM7TDMI(Scheduler& scheduler, Bus& bus)
       : scheduler(scheduler)
       , bus(bus) {
-    scheduler.Register(Scheduler::EventClass::ARM_ldm_usermode_conflict, this, &ARM7TDMI::ClearLDMUsermodeConflictFlag);
+    scheduler.Register<&ARM7TDMI::ClearLDMUsermodeConflictFlag>(Scheduler::EventClass::ARM_ldm_usermode_conflict, this);
 
     Reset();
   }
 
   auto IRQLine() -> bool& { return irq_line; }
+  auto PCHookBitmap() -> HookBitmap& { return pc_hook_bitmap; }
+  auto PCHookPending() -> bool& { return pc_hook_pending; }
 
   void Reset() {
     state.Reset();
@@ -50,14 +53,33 @@ struct ARM7TDMI {
     latch_irq_disable = state.cpsr.f.mask_irq;
     ldm_usermode_conflict = false;
     cpu_mode_is_invalid = false;
+    pc_hook_pending = false;
   }
 
   auto GetFetchedOpcode(int slot) -> u32 {
     return pipe.opcode[slot];
   }
 
+  // Refills the pipeline after r15 or the Thumb bit were changed from outside of the CPU.
+  void FlushPipeline() {
+    if(state.cpsr.f.thumb) {
+      state.r15 &= ~1;
+      ReloadPipeline16();
+    } else {
+      state.r15 &= ~3;
+      ReloadPipeline32();
+    }
+  }
+
   void Run() {
-    if(IRQLine()) SignalIRQ();
+    if(IRQLine()) {
+      SignalIRQ();
+
+      // Give the hooks on the IRQ vector a chance to run before its first instruction.
+      if(pc_hook_pending) [[unlikely]] {
+        return;
+      }
+    }
 
     auto instruction = pipe.opcode[0];
 
@@ -231,7 +253,18 @@ private:
     return s_condition_lut[(static_cast<int>(condition) << 4) | (state.cpsr.v >> 28)];
   }
 
+  /* Hooks are only checked for branch targets, which keeps the cost away from sequential code.
+   * The hooks are dispatched by the core, once the current instruction has completed.
+   */
+  void CheckPCHook() {
+    if(pc_hook_bitmap.Test(state.r15)) [[unlikely]] {
+      pc_hook_pending = true;
+    }
+  }
+
   void ReloadPipeline16() {
+    CheckPCHook();
+
     pipe.opcode[0] = bus.ReadHalf(state.r15 + 0, Access::Code | Access::Nonsequential);
     pipe.opcode[1] = bus.ReadHalf(state.r15 + 2, Access::Code | Access::Sequential);
     pipe.access = Access::Code | Access::Sequential;
@@ -241,6 +274,8 @@ private:
   }
 
   void ReloadPipeline32() {
+    CheckPCHook();
+
     pipe.opcode[0] = bus.ReadWord(state.r15 + 0, Access::Code | Access::Nonsequential);
     pipe.opcode[1] = bus.ReadWord(state.r15 + 4, Access::Code | Access::Sequential);
     pipe.access = Access::Code | Access::Sequential;
@@ -292,6 +327,9 @@ private:
   bool irq_line;
   bool latch_irq_disable;
 
+  HookBitmap pc_hook_bitmap;
+  bool pc_hook_pending;
+
   static std::array<bool, 256> s_condition_lut;
   static std::array<Handler16, 1024> s_opcode_lut_16;
   static std::array<Handler32, 4096> s_opcode_lut_32;
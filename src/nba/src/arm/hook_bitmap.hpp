@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <memory>
+#include <nba/integer.hpp>
+
+namespace nba::core::arm {
+
+/* Marks the instruction addresses which have a hook attached, with one bit per halfword.
+ * The bitmap is split into 64 KiB pages, which only are allocated once they contain a hook.
+ * Testing an address in a page without hooks therefore only costs a single load.
+ */
+struct HookBitmap {
+  bool Test(u32 address) const {
+    auto& page = pages[(address >> kPageShift) & kPageMask];
+
+    return page && page->test((address & kPageOffsetMask) >> 1);
+  }
+
+  void Set(u32 address, bool value) {
+    auto& page = pages[(address >> kPageShift) & kPageMask];
+
+    if(!page) {
+      if(!value) return;
+      page = std::make_unique<Page>();
+    }
+
+    page->set((address & kPageOffsetMask) >> 1, value);
+  }
+
+private:
+  static constexpr int kPageShift = 16;
+  static constexpr u32 kPageOffsetMask = (1 << kPageShift) - 1;
+
+  // Addresses above 0x0FFFFFFF alias into the same pages, hooks are matched against the full address anyway.
+  static constexpr int kPageCount = 1 << (28 - kPageShift);
+  static constexpr u32 kPageMask = kPageCount - 1;
+
+  using Page = std::bitset<(1 << kPageShift) / sizeof(u16)>;
+
+  std::array<std::unique_ptr<Page>, kPageCount> pages;
+};
+
+} // namespace nba::core::arm
@@ -42,6 +42,7 @@ void ARM7TDMI::LoadState(SaveState const& save_state) {
   ldm_usermode_conflict = false;
   cpu_mode_is_invalid = false;
   latch_irq_disable = state.cpsr.f.mask_irq;
+  pc_hook_pending = false;
 }
 
 void ARM7TDMI::CopyState(SaveState& save_state) {
@@ -0,0 +1,819 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <nba/log.hpp>
+
+#include "bios/hle.hpp"
+
+namespace nba::core {
+
+// Rough number of cycles spent executing BIOS code, not counting the data accesses.
+static constexpr int kSWIDispatchCycles = 30;
+static constexpr int kDivCycles = 60;
+static constexpr int kSqrtCycles = 80;
+static constexpr int kArcTanCycles = 50;
+static constexpr int kArcTan2Cycles = 110;
+static constexpr int kCpuSetCyclesPerUnit = 6;
+static constexpr int kCpuFastSetCyclesPerBlock = 8;
+static constexpr int kAffineSetCyclesPerEntry = 30;
+static constexpr int kUnCompCyclesPerFlag = 6;
+static constexpr int kUnCompCyclesPerByte = 6;
+
+// Value of the BIOS open bus latch after returning from a SWI.
+static constexpr u32 kBIOSLatchAfterSWI = 0xE3A02004;
+
+static const auto g_sine_table = []() {
+  // One full period of sin(x) in 256 steps, in 1.14 fixed point like the table in the BIOS.
+  const double pi = std::acos(-1.0);
+
+  std::array<s16, 256> table;
+
+  for(int i = 0; i < 256; i++) {
+    table[i] = (s16)std::round(std::sin(i * pi / 128.0) * 16384.0);
+  }
+  return table;
+}();
+
+// The BIOS refuses to copy or decompress data which is located in the BIOS itself.
+static bool IsBIOSAddress(u32 address) {
+  return (address & 0x0E000000) == 0;
+}
+
+static auto ArcTanPolynomial(s32 tan) -> s32 {
+  const s32 a = -((tan * tan) >> 14);
+
+  s32 b = ((0xA9 * a) >> 14) + 0x390;
+  b = ((b * a) >> 14) + 0x91C;
+  b = ((b * a) >> 14) + 0xFB6;
+  b = ((b * a) >> 14) + 0x16AA;
+  b = ((b * a) >> 14) + 0x2081;
+  b = ((b * a) >> 14) + 0x3651;
+  b = ((b * a) >> 14) + 0xA2F9;
+
+  return (tan * b) >> 16;
+}
+
+bool HLEBIOS::HandleSWI() {
+  auto& state = cpu.state;
+
+  /* In both ARM and Thumb mode the SWI number is held by the byte before the return address:
+   * the low byte of the Thumb instruction or bits 16 to 23 of the ARM comment field.
+   */
+  const auto number = bus.GetHostAddress<u8>(state.r14 - 2);
+
+  if(number == nullptr) {
+    return false;
+  }
+
+  switch(*number) {
+    case 0x00: {
+      // SoftReset does not return to the caller.
+      SoftReset();
+      return true;
+    }
+    case 0x01: RegisterRamReset(); break;
+    case 0x06: {
+      if(state.r1 == 0) return Unhandled(*number);
+      Div((s32)state.r0, (s32)state.r1);
+      break;
+    }
+    case 0x07: {
+      if(state.r0 == 0) return Unhandled(*number);
+      Div((s32)state.r1, (s32)state.r0);
+      break;
+    }
+    case 0x08: Sqrt(); break;
+    case 0x09: ArcTan(); break;
+    case 0x0A: ArcTan2(); break;
+    case 0x0B: CpuSet(); break;
+    case 0x0C: CpuFastSet(); break;
+    case 0x0E: BgAffineSet(); break;
+    case 0x0F: ObjAffineSet(); break;
+    case 0x10: BitUnPack(); break;
+    case 0x11: LZ77UnComp(false); break;
+    case 0x12: LZ77UnComp(true); break;
+    case 0x13: HuffUnComp(); break;
+    case 0x14: RLUnComp(false); break;
+    case 0x15: RLUnComp(true); break;
+    case 0x16: Diff8bitUnFilter(false); break;
+    case 0x17: Diff8bitUnFilter(true); break;
+    case 0x18: Diff16bitUnFilter(); break;
+    default: return Unhandled(*number);
+  }
+
+  ReturnFromSWI();
+  return true;
+}
+
+void HLEBIOS::SoftReset() {
+  auto& state = cpu.state;
+
+  // The entry point is selected by the byte at 0x03007FFA, which is read before it is cleared.
+  const u32 entry = bus.ReadByte(0x03007FFA, Bus::Nonsequential) ? 0x02000000 : 0x08000000;
+
+  ClearMemory(0x03007E00, 0x200);
+  Idle(kSWIDispatchCycles);
+
+  cpu.SwitchMode(arm::MODE_SYS);
+
+  for(int i = 0; i <= 12; i++) {
+    state.reg[i] = 0;
+  }
+
+  state.bank[arm::BANK_SVC][arm::BANK_R13] = 0x03007FE0;
+  state.bank[arm::BANK_SVC][arm::BANK_R14] = 0;
+  state.bank[arm::BANK_IRQ][arm::BANK_R13] = 0x03007FA0;
+  state.bank[arm::BANK_IRQ][arm::BANK_R14] = 0;
+  state.spsr[arm::BANK_SVC] = 0;
+  state.spsr[arm::BANK_IRQ] = 0;
+  state.r13 = 0x03007F00;
+  state.r14 = entry;
+  state.r15 = entry;
+  state.cpsr = arm::MODE_SYS;
+  cpu.FlushPipeline();
+}
+
+void HLEBIOS::RegisterRamReset() {
+  const u32 flags = cpu.state.r0;
+
+  // The display is always forced blank, regardless of the flags.
+  bus.WriteHalf(0x04000000, 0x0080, Bus::Nonsequential);
+
+  if(flags & 0x01) ClearMemory(0x02000000, 0x40000);
+  if(flags & 0x02) ClearMemory(0x03000000, 0x7E00); // The last 512 bytes hold the stacks.
+  if(flags & 0x04) ClearMemory(0x05000000, 0x400);
+  if(flags & 0x08) ClearMemory(0x06000000, 0x18000);
+  if(flags & 0x10) ClearMemory(0x07000000, 0x400);
+
+  const auto WriteIO = [&](u32 address, u16 value) {
+    bus.WriteHalf(address, value, Bus::Nonsequential);
+  };
+
+  const auto ClearIO = [&](u32 address_lo, u32 address_hi) {
+    for(u32 address = address_lo; address < address_hi; address += sizeof(u16)) {
+      WriteIO(address, 0);
+    }
+  };
+
+  if(flags & 0x20) {
+    WriteIO(0x04000128, 0);
+    WriteIO(0x04000134, 0x8000);
+    WriteIO(0x0400012A, 0);
+    WriteIO(0x04000140, 0);
+    ClearIO(0x04000150, 0x04000158);
+  }
+
+  if(flags & 0x40) {
+    ClearIO(0x04000060, 0x04000082);
+    WriteIO(0x04000084, 0);
+    WriteIO(0x04000088, 0x0200);
+    ClearIO(0x04000090, 0x040000A0);
+  }
+
+  if(flags & 0x80) {
+    ClearIO(0x04000004, 0x04000056);
+    WriteIO(0x04000020, 0x0100);
+    WriteIO(0x04000026, 0x0100);
+    WriteIO(0x04000030, 0x0100);
+    WriteIO(0x04000036, 0x0100);
+    ClearIO(0x040000B0, 0x040000E0);
+    ClearIO(0x04000100, 0x04000110);
+    WriteIO(0x04000200, 0);
+    WriteIO(0x04000202, 0xFFFF);
+    WriteIO(0x04000204, 0);
+    WriteIO(0x04000208, 0);
+  }
+}
+
+void HLEBIOS::Div(s32 numerator, s32 denominator) {
+  // 0x80000000 / -1 overflows, which the BIOS reports as a quotient of 0x80000000.
+  const s64 quotient = (s64)numerator / denominator;
+  const s64 remainder = (s64)numerator % denominator;
+
+  cpu.state.r0 = (u32)quotient;
+  cpu.state.r1 = (u32)remainder;
+  cpu.state.r3 = (u32)std::abs(quotient);
+
+  Idle(kDivCycles);
+}
+
+void HLEBIOS::Sqrt() {
+  u32 value = cpu.state.r0;
+  u32 result = 0;
+  u32 bit = 1u << 30;
+
+  while(bit > value) {
+    bit >>= 2;
+  }
+
+  while(bit != 0) {
+    if(value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  cpu.state.r0 = result;
+
+  Idle(kSqrtCycles);
+}
+
+void HLEBIOS::ArcTan() {
+  cpu.state.r0 = (u32)ArcTanPolynomial((s16)cpu.state.r0);
+
+  Idle(kArcTanCycles);
+}
+
+void HLEBIOS::ArcTan2() {
+  const s32 x = (s16)cpu.state.r0;
+  const s32 y = (s16)cpu.state.r1;
+
+  s32 angle;
+
+  if(y == 0) {
+    angle = x >= 0 ? 0 : 0x8000;
+  } else if(x == 0) {
+    angle = y >= 0 ? 0x4000 : 0xC000;
+  } else if(y >= 0) {
+    if(x >= 0 ? x >= y : -x >= y) {
+      angle = ArcTanPolynomial((y << 14) / x) + (x >= 0 ? 0 : 0x8000);
+    } else {
+      angle = 0x4000 - ArcTanPolynomial((x << 14) / y);
+    }
+  } else {
+    if(x <= 0 ? -x > -y : x >= -y) {
+      angle = ArcTanPolynomial((y << 14) / x) + (x <= 0 ? 0x8000 : 0x10000);
+    } else {
+      angle = 0xC000 - ArcTanPolynomial((x << 14) / y);
+    }
+  }
+
+  cpu.state.r0 = (u16)angle;
+
+  Idle(kArcTan2Cycles);
+}
+
+void HLEBIOS::CpuSet() {
+  u32 src = cpu.state.r0;
+  u32 dst = cpu.state.r1;
+  const u32 control = cpu.state.r2;
+  const int count = control & 0x1FFFFF;
+  const bool fill = control & (1 << 24);
+
+  if(IsBIOSAddress(src)) {
+    return;
+  }
+
+  if(control & (1 << 26)) {
+    src &= ~3;
+    dst &= ~3;
+
+    const u32 value = fill ? bus.ReadWord(src, Bus::Nonsequential) : 0;
+
+    for(int i = 0; i < count; i++) {
+      bus.WriteWord(dst, fill ? value : bus.ReadWord(src, Bus::Nonsequential), Bus::Nonsequential);
+      src += sizeof(u32);
+      dst += sizeof(u32);
+      Idle(kCpuSetCyclesPerUnit);
+    }
+  } else {
+    src &= ~1;
+    dst &= ~1;
+
+    const u16 value = fill ? bus.ReadHalf(src, Bus::Nonsequential) : 0;
+
+    for(int i = 0; i < count; i++) {
+      bus.WriteHalf(dst, fill ? value : bus.ReadHalf(src, Bus::Nonsequential), Bus::Nonsequential);
+      src += sizeof(u16);
+      dst += sizeof(u16);
+      Idle(kCpuSetCyclesPerUnit);
+    }
+  }
+}
+
+void HLEBIOS::CpuFastSet() {
+  u32 src = cpu.state.r0 & ~3;
+  u32 dst = cpu.state.r1 & ~3;
+  const u32 control = cpu.state.r2;
+  const bool fill = control & (1 << 24);
+
+  // The BIOS always transfers blocks of eight words, using LDM and STM.
+  const int blocks = ((control & 0x1FFFFF) + 7) / 8;
+
+  if(IsBIOSAddress(src)) {
+    return;
+  }
+
+  const u32 value = fill ? bus.ReadWord(src, Bus::Nonsequential) : 0;
+
+  for(int i = 0; i < blocks; i++) {
+    u32 buffer[8];
+
+    for(int j = 0; j < 8; j++) {
+      if(fill) {
+        buffer[j] = value;
+      } else {
+        buffer[j] = bus.ReadWord(src, j == 0 ? Bus::Nonsequential : Bus::Sequential);
+        src += sizeof(u32);
+      }
+    }
+
+    for(int j = 0; j < 8; j++) {
+      bus.WriteWord(dst, buffer[j], j == 0 ? Bus::Nonsequential : Bus::Sequential);
+      dst += sizeof(u32);
+    }
+
+    Idle(kCpuFastSetCyclesPerBlock);
+  }
+}
+
+void HLEBIOS::BgAffineSet() {
+  u32 src = cpu.state.r0;
+  u32 dst = cpu.state.r1;
+  const int count = (int)cpu.state.r2;
+
+  for(int i = 0; i < count; i++) {
+    const s32 origin_x = (s32)bus.ReadWord(src +  0, Bus::Nonsequential);
+    const s32 origin_y = (s32)bus.ReadWord(src +  4, Bus::Sequential);
+    const s32 center_x = (s16)bus.ReadHalf(src +  8, Bus::Sequential);
+    const s32 center_y = (s16)bus.ReadHalf(src + 10, Bus::Sequential);
+    const s32 scale_x  = (s16)bus.ReadHalf(src + 12, Bus::Sequential);
+    const s32 scale_y  = (s16)bus.ReadHalf(src + 14, Bus::Sequential);
+    const int angle = bus.ReadHalf(src + 16, Bus::Sequential) >> 8;
+
+    const s32 sin = g_sine_table[angle];
+    const s32 cos = g_sine_table[(angle + 64) & 255];
+
+    const s16 pa =  ((scale_x * cos) >> 14);
+    const s16 pb = -((scale_x * sin) >> 14);
+    const s16 pc =  ((scale_y * sin) >> 14);
+    const s16 pd =  ((scale_y * cos) >> 14);
+
+    bus.WriteHalf(dst +  0, (u16)pa, Bus::Nonsequential);
+    bus.WriteHalf(dst +  2, (u16)pb, Bus::Sequential);
+    bus.WriteHalf(dst +  4, (u16)pc, Bus::Sequential);
+    bus.WriteHalf(dst +  6, (u16)pd, Bus::Sequential);
+    bus.WriteWord(dst +  8, (u32)(origin_x - pa * center_x - pb * center_y), Bus::Sequential);
+    bus.WriteWord(dst + 12, (u32)(origin_y - pc * center_x - pd * center_y), Bus::Sequential);
+
+    src += 20;
+    dst += 16;
+    Idle(kAffineSetCyclesPerEntry);
+  }
+}
+
+void HLEBIOS::ObjAffineSet() {
+  u32 src = cpu.state.r0;
+  u32 dst = cpu.state.r1;
+  const int count = (int)cpu.state.r2;
+  const u32 stride = cpu.state.r3;
+
+  for(int i = 0; i < count; i++) {
+    const s32 scale_x = (s16)bus.ReadHalf(src + 0, Bus::Nonsequential);
+    const s32 scale_y = (s16)bus.ReadHalf(src + 2, Bus::Sequential);
+    const int angle = bus.ReadHalf(src + 4, Bus::Sequential) >> 8;
+
+    const s32 sin = g_sine_table[angle];
+    const s32 cos = g_sine_table[(angle + 64) & 255];
+
+    bus.WriteHalf(dst + stride * 0, (u16) ((scale_x * cos) >> 14), Bus::Nonsequential);
+    bus.WriteHalf(dst + stride * 1, (u16)-((scale_x * sin) >> 14), Bus::Nonsequential);
+    bus.WriteHalf(dst + stride * 2, (u16) ((scale_y * sin) >> 14), Bus::Nonsequential);
+    bus.WriteHalf(dst + stride * 3, (u16) ((scale_y * cos) >> 14), Bus::Nonsequential);
+
+    src += 8;
+    dst += stride * 4;
+    Idle(kAffineSetCyclesPerEntry);
+  }
+}
+
+namespace {
+
+/* Destination of the decompression functions. The VRAM variants write 16-bit units,
+ * because VRAM does not support 8-bit writes, so every other byte is held back.
+ */
+struct UnCompOutput {
+  UnCompOutput(Bus& bus, u32 address, bool vram) : bus(bus), address(address), vram(vram) {}
+
+  void Write(u8 value) {
+    if(!vram) {
+      bus.WriteByte(address, value, Bus::Nonsequential);
+    } else if(address & 1) {
+      bus.WriteHalf(address & ~1, buffer | (value << 8), Bus::Nonsequential);
+    } else {
+      buffer = value;
+    }
+    address++;
+  }
+
+  // Reads back a byte which was already decompressed.
+  auto Read(u32 distance) -> u8 {
+    const u32 source = address - distance;
+
+    if(vram && (address & 1) && distance == 1) {
+      return (u8)buffer;
+    }
+    return bus.ReadByte(source, Bus::Nonsequential);
+  }
+
+  Bus& bus;
+  u32 address;
+  bool vram;
+  u16 buffer = 0;
+};
+
+} // anonymous namespace
+
+void HLEBIOS::LZ77UnComp(bool vram) {
+  u32 src = cpu.state.r0;
+
+  if(IsBIOSAddress(src)) {
+    return;
+  }
+
+  UnCompOutput output{bus, cpu.state.r1, vram};
+
+  int remaining = bus.ReadWord(src & ~3, Bus::Nonsequential) >> 8;
+
+  src += sizeof(u32);
+
+  while(remaining > 0) {
+    u8 flags = bus.ReadByte(src++, Bus::Nonsequential);
+
+    Idle(kUnCompCyclesPerFlag);
+
+    for(int i = 0; i < 8 && remaining > 0; i++) {
+      if(flags & 0x80) {
+        const u8 byte0 = bus.ReadByte(src++, Bus::Nonsequential);
+        const u8 byte1 = bus.ReadByte(src++, Bus::Nonsequential);
+        const int length = (byte0 >> 4) + 3;
+        const u32 distance = (((byte0 & 15) << 8) | byte1) + 1;
+
+        for(int j = 0; j < length && remaining > 0; j++) {
+          output.Write(output.Read(distance));
+          remaining--;
+          Idle(kUnCompCyclesPerByte);
+        }
+      } else {
+        output.Write(bus.ReadByte(src++, Bus::Nonsequential));
+        remaining--;
+        Idle(kUnCompCyclesPerByte);
+      }
+
+      flags <<= 1;
+    }
+  }
+}
+
+void HLEBIOS::HuffUnComp() {
+  u32 src = cpu.state.r0 & ~3;
+  u32 dst = cpu.state.r1 & ~3;
+
+  if(IsBIOSAddress(src)) {
+    return;
+  }
+
+  const u32 header = bus.ReadWord(src, Bus::Nonsequential);
+  const int data_bits = header & 15;
+  const int size = header >> 8;
+
+  if(data_bits == 0 || 32 % data_bits != 0) {
+    return;
+  }
+
+  const u32 root = src + 5;
+  const u32 tree_size = bus.ReadByte(src + 4, Bus::Nonsequential);
+
+  u32 stream = src + 4 + (tree_size + 1) * 2;
+  u32 node_address = root;
+  u8  node = bus.ReadByte(root, Bus::Nonsequential);
+  u32 word = 0;
+  int word_bits = 0;
+  int written = 0;
+
+  while(written < size) {
+    const u32 bits = bus.ReadWord(stream, Bus::Nonsequential);
+
+    stream += sizeof(u32);
+
+    for(int i = 31; i >= 0 && written < size; i--) {
+      const int bit = (bits >> i) & 1;
+
+      // Bit 7 of a node marks its first child as data, bit 6 marks its second child as data.
+      const bool is_data = node & (0x80 >> bit);
+
+      node_address = (node_address & ~1) + (node & 0x3F) * 2 + 2 + bit;
+      node = bus.ReadByte(node_address, Bus::Nonsequential);
+
+      if(is_data) {
+        word |= (node & ((1 << data_bits) - 1)) << word_bits;
+        word_bits += data_bits;
+
+        if(word_bits == 32) {
+          bus.WriteWord(dst, word, Bus::Nonsequential);
+          dst += sizeof(u32);
+          written += sizeof(u32);
+          word = 0;
+          word_bits = 0;
+        }
+
+        node_address = root;
+        node = bus.ReadByte(root, Bus::Nonsequential);
+        Idle(kUnCompCyclesPerByte);
+      }
+    }
+  }
+}
+
+void HLEBIOS::RLUnComp(bool vram) {
+  u32 src = cpu.state.r0;
+
+  if(IsBIOSAddress(src)) {
+    return;
+  }
+
+  UnCompOutput output{bus, cpu.state.r1, vram};
+
+  int remaining = bus.ReadWord(src & ~3, Bus::Nonsequential) >> 8;
+
+  src += sizeof(u32);
+
+  while(remaining > 0) {
+    const u8 flag = bus.ReadByte(src++, Bus::Nonsequential);
+
+    Idle(kUnCompCyclesPerFlag);
+
+    if(flag & 0x80) {
+      const int length = (flag & 0x7F) + 3;
+      const u8 value = bus.ReadByte(src++, Bus::Nonsequential);
+
+      for(int i = 0; i < length && remaining > 0; i++) {
+        output.Write(value);
+        remaining--;
+        Idle(kUnCompCyclesPerByte);
+      }
+    } else {
+      const int length = (flag & 0x7F) + 1;
+
+      for(int i = 0; i < length && remaining > 0; i++) {
+        output.Write(bus.ReadByte(src++, Bus::Nonsequential));
+        remaining--;
+        Idle(kUnCompCyclesPerByte);
+      }
+    }
+  }
+}
+
+void HLEBIOS::BitUnPack() {
+  u32 src = cpu.state.r0;
+  u32 dst = cpu.state.r1;
+  const u32 info = cpu.state.r2;
+
+  if(IsBIOSAddress(src)) {
+    return;
+  }
+
+  const int length = bus.ReadHalf(info, Bus::Nonsequential);
+  const int src_bits = bus.ReadByte(info + 2, Bus::Nonsequential);
+  const int dst_bits = bus.ReadByte(info + 3, Bus::Nonsequential);
+  const u32 offset = bus.ReadWord(info + 4, Bus::Nonsequential);
+
+  // Bit 31 of the offset selects whether the offset is also added to zero units.
+  const bool offset_zero = offset >> 31;
+
+  const auto IsValidWidth = [](int bits) {
+    return bits != 0 && bits <= 32 && (bits & (bits - 1)) == 0;
+  };
+
+  if(!IsValidWidth(src_bits) || src_bits > 8 || !IsValidWidth(dst_bits)) {
+    return;
+  }
+
+  u32 word = 0;
+  int word_bits = 0;
+
+  for(int i = 0; i < length; i++) {
+    const u8 byte = bus.ReadByte(src++, Bus::Nonsequential);
+
+    for(int bit = 0; bit < 8; bit += src_bits) {
+      u32 unit = (byte >> bit) & ((1 << src_bits) - 1);
+
+      if(unit != 0 || offset_zero) {
+        unit += offset & 0x7FFFFFFF;
+      }
+
+      word |= unit << word_bits;
+      word_bits += dst_bits;
+
+      if(word_bits == 32) {
+        bus.WriteWord(dst, word, Bus::Nonsequential);
+        dst += sizeof(u32);
+        word = 0;
+        word_bits = 0;
+      }
+
+      Idle(kUnCompCyclesPerByte);
+    }
+  }
+}
+
+void HLEBIOS::Diff8bitUnFilter(bool vram) {
+  u32 src = cpu.state.r0;
+
+  if(IsBIOSAddress(src)) {
+    return;
+  }
+
+  UnCompOutput output{bus, cpu.state.r1, vram};
+
+  int remaining = bus.ReadWord(src & ~3, Bus::Nonsequential) >> 8;
+  u8 value = 0;
+
+  src += sizeof(u32);
+
+  // The first unit is stored as is, every following unit is the difference to its predecessor.
+  while(remaining-- > 0) {
+    value += bus.ReadByte(src++, Bus::Nonsequential);
+    output.Write(value);
+    Idle(kUnCompCyclesPerByte);
+  }
+}
+
+void HLEBIOS::Diff16bitUnFilter() {
+  u32 src = cpu.state.r0;
+  u32 dst = cpu.state.r1;
+
+  if(IsBIOSAddress(src)) {
+    return;
+  }
+
+  int remaining = bus.ReadWord(src & ~3, Bus::Nonsequential) >> 8;
+  u16 value = 0;
+
+  src += sizeof(u32);
+
+  while(remaining >= (int)sizeof(u16)) {
+    value += bus.ReadHalf(src, Bus::Nonsequential);
+    bus.WriteHalf(dst, value, Bus::Nonsequential);
+    src += sizeof(u16);
+    dst += sizeof(u16);
+    remaining -= sizeof(u16);
+    Idle(kUnCompCyclesPerByte);
+  }
+}
+
+bool HLEBIOS::Unhandled(u8 number) {
+  // The stub BIOS only implements Halt, IntrWait and VBlankIntrWait, all other SWIs return immediately.
+  const bool stub_handles_swi = number == 0x02 || number == 0x04 || number == 0x05;
+
+  if(using_stub_bios && !stub_handles_swi && !reported_swis[number]) {
+    Log<Warn>("HLEBIOS: unimplemented SWI 0x{:02X} called from 0x{:08X}", number, cpu.state.r14);
+    reported_swis[number] = true;
+  }
+  return false;
+}
+
+void HLEBIOS::ClearMemory(u32 address, u32 size) {
+  // Like CpuFastSet, memory is cleared in blocks of eight words.
+  for(u32 i = 0; i < size; i += sizeof(u32)) {
+    bus.WriteWord(address + i, 0, (i & 31) == 0 ? Bus::Nonsequential : Bus::Sequential);
+
+    if((i & 31) == 28) {
+      Idle(kCpuFastSetCyclesPerBlock);
+    }
+  }
+}
+
+void HLEBIOS::ReturnFromSWI() {
+  auto& state = cpu.state;
+  const auto spsr = state.spsr[arm::BANK_SVC];
+
+  Idle(kSWIDispatchCycles);
+
+  // Equivalent to MOVS PC, LR in supervisor mode.
+  state.r15 = state.r14;
+  cpu.SwitchMode(spsr.f.mode);
+  state.cpsr = spsr;
+  cpu.FlushPipeline();
+
+  bus.memory.latch.bios = kBIOSLatchAfterSWI;
+}
+
+void HLEBIOS::Idle(int cycles) {
+  for(int i = 0; i < cycles; i++) {
+    bus.Idle();
+  }
+}
+
+auto HLEBIOS::GetStubBIOS() -> std::vector<u8> {
+  static constexpr u32 kStubBIOS[] {
+    // Exception vectors
+    0xEA000006, // 0x000: b reset
+    0xEA000010, // 0x004: b hang
+    0xEA000016, // 0x008: b swi
+    0xE25EF004, // 0x00C: subs pc, lr, #4
+    0xE25EF004, // 0x010: subs pc, lr, #4
+    0xEA00000C, // 0x014: b hang
+    0xEA00000C, // 0x018: b irq
+    0xE25EF004, // 0x01C: subs pc, lr, #4
+
+    // reset: set up the stacks like the BIOS does and enter the ROM in system mode.
+    0xE3A000D3, // 0x020: mov r0, #0xD3
+    0xE121F000, // 0x024: msr cpsr_c, r0
+    0xE59FD0D4, // 0x028: ldr sp, =0x03007FE0
+    0xE3A000D2, // 0x02C: mov r0, #0xD2
+    0xE121F000, // 0x030: msr cpsr_c, r0
+    0xE59FD0CC, // 0x034: ldr sp, =0x03007FA0
+    0xE3A0001F, // 0x038: mov r0, #0x1F
+    0xE121F000, // 0x03C: msr cpsr_c, r0
+    0xE59FD0C4, // 0x040: ldr sp, =0x03007F00
+    0xE3A0E302, // 0x044: mov lr, #0x08000000
+    0xE12FFF1E, // 0x048: bx lr
+
+    // hang:
+    0xEAFFFFFE, // 0x04C: b hang
+
+    // irq: call the user handler at [0x03007FFC].
+    0xE92D500F, // 0x050: stmfd sp!, {r0-r3, r12, lr}
+    0xE3A00301, // 0x054: mov r0, #0x04000000
+    0xE28FE000, // 0x058: add lr, pc, #0
+    0xE510F004, // 0x05C: ldr pc, [r0, #-4]
+    0xE8BD500F, // 0x060: ldmfd sp!, {r0-r3, r12, lr}
+    0xE25EF004, // 0x064: subs pc, lr, #4
+
+    // swi: Halt, IntrWait and VBlankIntrWait, all other SWIs are left to HLE or return immediately.
+    0xE92D5800, // 0x068: stmfd sp!, {r11, r12, lr}
+    0xE55EC002, // 0x06C: ldrb r12, [lr, #-2]
+    0xE35C0002, // 0x070: cmp r12, #2
+    0x0A000007, // 0x074: beq halt
+    0xE35C0005, // 0x078: cmp r12, #5
+    0x03A00001, // 0x07C: moveq r0, #1
+    0x03A01001, // 0x080: moveq r1, #1
+    0xE35C0004, // 0x084: cmp r12, #4
+    0x135C0005, // 0x088: cmpne r12, #5
+    0x0A000004, // 0x08C: beq intr_wait
+    // swi_return:
+    0xE8BD5800, // 0x090: ldmfd sp!, {r11, r12, lr}
+    0xE1B0F00E, // 0x094: movs pc, lr
+
+    // halt:
+    0xE3A0C301, // 0x098: mov r12, #0x04000000
+    0xE5CCC301, // 0x09C: strb r12, [r12, #0x301]
+    0xEAFFFFFA, // 0x0A0: b swi_return
+
+    // intr_wait: wait in system mode with IRQs enabled until any of the flags in r1 is set in [0x03007FF8].
+    0xE14FB000, // 0x0A4: mrs r11, spsr
+    0xE92D0800, // 0x0A8: stmfd sp!, {r11}
+    0xE3A0C301, // 0x0AC: mov r12, #0x04000000
+    0xE3A0B001, // 0x0B0: mov r11, #1
+    0xE5CCB208, // 0x0B4: strb r11, [r12, #0x208]
+    0xE3500000, // 0x0B8: cmp r0, #0
+    0x115CB0B8, // 0x0BC: ldrhne r11, [r12, #-8]
+    0x11CBB001, // 0x0C0: bicne r11, r11, r1
+    0x114CB0B8, // 0x0C4: strhne r11, [r12, #-8]
+    0xE321F09F, // 0x0C8: msr cpsr_c, #0x9F
+    0x1A000004, // 0x0CC: bne intr_wait_halt
+    // intr_wait_check:
+    0xE15CB0B8, // 0x0D0: ldrh r11, [r12, #-8]
+    0xE11B0001, // 0x0D4: tst r11, r1
+    0x11CBB001, // 0x0D8: bicne r11, r11, r1
+    0x114CB0B8, // 0x0DC: strhne r11, [r12, #-8]
+    0x1A000003, // 0x0E0: bne intr_wait_done
+    // intr_wait_halt:
+    0xE321F01F, // 0x0E4: msr cpsr_c, #0x1F
+    0xE5CCC301, // 0x0E8: strb r12, [r12, #0x301]
+    0xE321F09F, // 0x0EC: msr cpsr_c, #0x9F
+    0xEAFFFFF6, // 0x0F0: b intr_wait_check
+    // intr_wait_done:
+    0xE321F093, // 0x0F4: msr cpsr_c, #0x93
+    0xE8BD0800, // 0x0F8: ldmfd sp!, {r11}
+    0xE169F00B, // 0x0FC: msr spsr_fc, r11
+    0xEAFFFFE2, // 0x100: b swi_return
+
+    // Literal pool
+    0x03007FE0, // 0x104
+    0x03007FA0, // 0x108
+    0x03007F00  // 0x10C
+  };
+
+  std::vector<u8> bios;
+
+  for(u32 word : kStubBIOS) {
+    for(int i = 0; i < 4; i++) {
+      bios.push_back((u8)(word >> (i * 8)));
+    }
+  }
+  return bios;
+}
+
+} // namespace nba::core
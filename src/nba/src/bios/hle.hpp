@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <bitset>
+#include <nba/integer.hpp>
+#include <vector>
+
+#include "arm/arm7tdmi.hpp"
+#include "bus/bus.hpp"
+
+namespace nba::core {
+
+/* High-level emulation of frequently used BIOS functions.
+ * When the CPU enters the SWI exception vector, the function is executed natively
+ * and the CPU immediately returns to the caller. All memory accesses still go through
+ * the bus, so that they are timed like the accesses that the BIOS code would do.
+ * Only the cost of executing the BIOS code itself is approximated.
+ *
+ * Unlike the BIOS, which runs most functions with the caller's IRQ mask,
+ * IRQs are only serviced once the function has returned.
+ */
+struct HLEBIOS {
+  HLEBIOS(arm::ARM7TDMI& cpu, Bus& bus) : cpu(cpu), bus(bus) {}
+
+  static constexpr u32 kSWIVector = 0x08;
+
+  // Returns false if the SWI is not emulated and must be handled by the BIOS.
+  bool HandleSWI();
+
+  /* Minimal BIOS for use without a BIOS file: it jumps straight to the ROM on reset,
+   * dispatches IRQs to the user handler and implements the SWIs for waiting on IRQs.
+   */
+  static auto GetStubBIOS() -> std::vector<u8>;
+
+  // Set when the stub BIOS is used, so that SWIs which neither of them implements are reported.
+  auto UsingStubBIOS() -> bool& { return using_stub_bios; }
+
+private:
+  void SoftReset();
+  void RegisterRamReset();
+  void Div(s32 numerator, s32 denominator);
+  void Sqrt();
+  void ArcTan();
+  void ArcTan2();
+  void CpuSet();
+  void CpuFastSet();
+  void BgAffineSet();
+  void ObjAffineSet();
+  void LZ77UnComp(bool vram);
+  void HuffUnComp();
+  void RLUnComp(bool vram);
+  void BitUnPack();
+  void Diff8bitUnFilter(bool vram);
+  void Diff16bitUnFilter();
+
+  bool Unhandled(u8 number);
+  void ClearMemory(u32 address, u32 size);
+  void ReturnFromSWI();
+  void Idle(int cycles);
+
+  arm::ARM7TDMI& cpu;
+  Bus& bus;
+  bool using_stub_bios = false;
+  std::bitset<256> reported_swis;
+};
+
+} // namespace nba::core
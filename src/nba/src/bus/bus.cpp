@@ -20,10 +20,14 @@ namespace nba::core {
 Bus::Bus(Scheduler& scheduler, Hardware&& hw)
     : scheduler(scheduler)
     , hw(hw) {
-  scheduler.Register(Scheduler::EventClass::SIO_transfer_done, this, &Bus::SIOTransferDone);
+  scheduler.Register<&Bus::SIOTransferDone>(Scheduler::EventClass::SIO_transfer_done, this);
 
   this->hw.bus = this;
   memory.bios.fill(0);
+
+  memory_pages[0x02] = {memory.wram.data(), 0x3FFFF, 3, 6};
+  memory_pages[0x03] = {memory.iram.data(), 0x07FFF, 1, 1};
+
   Reset();
 }
 
@@ -43,6 +47,7 @@ void Bus::Reset() {
   prefetch = {};
   last_access = 0;
   parallel_internal_cpu_cycle_limit = 0;
+  idle_loop_monitor = {};
   UpdateWaitStateTable();
 }
 
@@ -85,33 +90,41 @@ void Bus::WriteWord(u32 address, u32 value, int access) {
 template<typename T>
 auto Bus::Read(u32 address, int access) -> T {
   auto page = address >> 24;
-  auto is_u32 = std::is_same_v<T, u32>;
+  auto& memory_page = memory_pages[page];
+
+  /* Fast path for EWRAM and IWRAM, unless a DMA must run first.
+   * The idle loop monitor does not care about reads from these regions.
+   */
+  if(memory_page.data != nullptr && ((access & (Dma | Lock)) || !hw.dma.IsRunning())) {
+    parallel_internal_cpu_cycle_limit = 0;
+    Step(std::is_same_v<T, u32> ? memory_page.cycles32 : memory_page.cycles16);
+    const T value = read<T>(memory_page.data, Align<T>(address) & memory_page.mask);
+    last_access = access;
+    return value;
+  }
 
   // Set last_access to access right before returning.
   auto _ = ScopeExit{[&]() {
     last_access = access;
   }};
 
+  if(idle_loop_monitor.enabled) MonitorRead(address, access, sizeof(T));
+
   if(!(access & (Dma | Lock)) && hw.dma.IsRunning()) hw.dma.Run();
 
   parallel_internal_cpu_cycle_limit = 0;
 
+  if(memory_page.data != nullptr) {
+    Step(std::is_same_v<T, u32> ? memory_page.cycles32 : memory_page.cycles16);
+    return read<T>(memory_page.data, Align<T>(address) & memory_page.mask);
+  }
+
   switch(page) {
     // BIOS
     case 0x00: {
       Step(1);
       return ReadBIOS(Align<T>(address));
     }
-    // EWRAM (external work RAM)
-    case 0x02: {
-      Step(is_u32 ? 6 : 3);
-      return read<T>(memory.wram.data(), Align<T>(address) & 0x3FFFF);
-    }
-    // IWRAM (internal work RAM)
-    case 0x03: {
-      Step(1);
-      return read<T>(memory.iram.data(), Align<T>(address) & 0x7FFF);
-    }
     // MMIO
     case 0x04: {
       Step(1);
@@ -187,25 +200,23 @@ auto Bus::Read(u32 address, int access) -> T {
 template<typename T>
 void Bus::Write(u32 address, int access, T value) {
   auto page = address >> 24;
-  auto is_u32 = std::is_same_v<T, u32>;
+
+  if(idle_loop_monitor.enabled) idle_loop_monitor.side_effects = true;
 
   if(!(access & (Dma | Lock)) && hw.dma.IsRunning()) hw.dma.Run();
 
   parallel_internal_cpu_cycle_limit = 0;
 
+  auto& memory_page = memory_pages[page];
+
+  if(memory_page.data != nullptr) {
+    Step(std::is_same_v<T, u32> ? memory_page.cycles32 : memory_page.cycles16);
+    write<T>(memory_page.data, Align<T>(address) & memory_page.mask, value);
+    last_access = access;
+    return;
+  }
+
   switch(page) {
-    // EWRAM (external work RAM)
-    case 0x02: {
-      Step(is_u32 ? 6 : 3);
-      write<T>(memory.wram.data(), Align<T>(address) & 0x3FFFF, value);
-      break;
-    }
-    // IWRAM (internal work RAM)
-    case 0x03: {
-      Step(1);
-      write<T>(memory.iram.data(), Align<T>(address) & 0x7FFF,  value);
-      break;
-    }
     // MMIO
     case 0x04: {
       Step(1);
@@ -284,6 +295,37 @@ void Bus::Write(u32 address, int access, T value) {
   last_access = access;
 }
 
+void Bus::MonitorRead(u32 address, int access, int size) {
+  const auto page = address >> 24;
+
+  if(access & Code) {
+    // Fetching code is fine, unless it is fetched from video memory or the backup memory.
+    if(page <= 0x03 || (page >= 0x08 && page <= 0x0D)) {
+      return;
+    }
+  } else if(page == 0x02 || page == 0x03) {
+    return;
+  } else if(page == 0x04) {
+    // These registers only change in response to scheduler events or key input in between frames.
+    static constexpr u32 kPollableIO[][2] {
+      { DISPSTAT, VCOUNT + 2 },
+      { KEYINPUT, KEYCNT + 2 },
+      { IE, IF + 2 },
+      { IME, IME + 4 }
+    };
+
+    address &= ~(size - 1);
+
+    for(auto& range : kPollableIO) {
+      if(address >= range[0] && address + size <= range[1]) {
+        return;
+      }
+    }
+  }
+
+  idle_loop_monitor.side_effects = true;
+}
+
 auto Bus::ReadBIOS(u32 address) -> u32 {
   if(address >= 0x4000) {
     return ReadOpenBus(address);
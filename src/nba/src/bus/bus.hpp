@@ -123,6 +123,27 @@ struct Bus {
   int last_access;
   int parallel_internal_cpu_cycle_limit;
 
+  /* Plain memory regions (EWRAM and IWRAM), indexed by the upper eight address bits.
+   * Read() and Write() access these directly, the remaining regions go through a switch.
+   */
+  struct MemoryPage {
+    u8* data = nullptr;
+    u32 mask = 0;
+    int cycles16 = 0;
+    int cycles32 = 0;
+  };
+
+  std::array<MemoryPage, 256> memory_pages;
+
+  /* Used by the idle loop detection to find out if the CPU did anything since
+   * monitoring was enabled, that either has side effects or may observe state
+   * which changes without a scheduler event.
+   */
+  struct IdleLoopMonitor {
+    bool enabled = false;
+    bool side_effects = false;
+  } idle_loop_monitor;
+
   template<typename T>
   auto Read(u32 address, int access) -> T;
   
@@ -141,7 +162,7 @@ struct Bus {
     for(int i = 0; i < cycles; i++) {
       do {
         Step(1);
-        hw.ppu.Sync();
+        hw.ppu.SyncPRAM();
       } while(hw.ppu.DidAccessPRAM());
     }
 
@@ -153,7 +174,7 @@ struct Bus {
     if constexpr (!std::is_same_v<T, u32>) {
       do {
         Step(1);
-        hw.ppu.Sync();
+        hw.ppu.SyncPRAM();
       } while(hw.ppu.DidAccessPRAM());
 
       hw.ppu.WritePRAM<T>(address, value);
@@ -175,7 +196,7 @@ struct Bus {
       for(int i = 0; i < cycles; i++) {
         do {
           Step(1);
-          hw.ppu.Sync();
+          hw.ppu.SyncVRAM_OBJ();
         } while(hw.ppu.DidAccessVRAM_OBJ());
       }
 
@@ -184,7 +205,7 @@ struct Bus {
       for(int i = 0; i < cycles; i++) {
         do {
           Step(1);
-          hw.ppu.Sync();
+          hw.ppu.SyncVRAM_BG();
         } while(hw.ppu.DidAccessVRAM_BG());
       }
 
@@ -203,7 +224,7 @@ struct Bus {
         // TODO: de-duplicate this code (see ReadVRAM):
         do {
           Step(1);
-          hw.ppu.Sync();
+          hw.ppu.SyncVRAM_OBJ();
         } while(hw.ppu.DidAccessVRAM_OBJ());
 
         hw.ppu.WriteVRAM_OBJ<T>(address, value, boundary);
@@ -211,7 +232,7 @@ struct Bus {
         // TODO: de-duplicate this code (see ReadVRAM):
         do {
           Step(1);
-          hw.ppu.Sync();
+          hw.ppu.SyncVRAM_BG();
         } while(hw.ppu.DidAccessVRAM_BG());
 
         hw.ppu.WriteVRAM_BG<T>(address, value);
@@ -226,7 +247,7 @@ struct Bus {
   auto ALWAYS_INLINE ReadOAM(u32 address) noexcept -> T {
     do {
       Step(1);
-      hw.ppu.Sync();
+      hw.ppu.SyncOAM();
     } while(hw.ppu.DidAccessOAM());
 
     return hw.ppu.ReadOAM<T>(address);
@@ -236,7 +257,7 @@ struct Bus {
   void ALWAYS_INLINE WriteOAM(u32 address, T value) noexcept {
     do {
       Step(1);
-      hw.ppu.Sync();
+      hw.ppu.SyncOAM();
     } while(hw.ppu.DidAccessOAM());
 
     hw.ppu.WriteOAM<T>(address, value);
@@ -245,11 +266,14 @@ struct Bus {
   auto ReadBIOS(u32 address) -> u32;
   auto ReadOpenBus(u32 address) -> u32;
 
+  void MonitorRead(u32 address, int access, int size);
+
   void SIOTransferDone();
 
   void Prefetch(u32 address, bool code, int cycles);
   void StopPrefetch();
   void Step(int cycles);
+  void StepBurst(int read_cycles, int write_cycles, int count);
   void UpdateWaitStateTable();
 
   void LoadState(SaveState const& state);
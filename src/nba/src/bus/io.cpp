@@ -5,6 +5,7 @@
  * Refer to the included LICENSE file.
  */
 
+#include <array>
 #include <cstdio>
 
 #include "arm/arm7tdmi.hpp"
@@ -13,6 +14,208 @@
 
 namespace nba::core {
 
+namespace {
+
+using Hardware = Bus::Hardware;
+
+/* Describes how a native 16-bit or 32-bit access to a halfword in 0x04000000 - 0x040003FF is handled.
+ * Registers either provide their own 16-bit or 32-bit accessors, or are plain values which the handler stores after applying the write mask.
+ * Byte writes to the plain values are merged into a 16-bit write, so that their behaviour is only defined here.
+ * All other accesses are split into byte accesses.
+ */
+struct IORegister {
+  using ReadHalfFn  = u16  (*)(Hardware& hw, u32 address);
+  using ReadWordFn  = u32  (*)(Hardware& hw, u32 address);
+  using WriteHalfFn = void (*)(Hardware& hw, u32 address, u16 value);
+  using WriteWordFn = void (*)(Hardware& hw, u32 address, u32 value);
+
+  ReadHalfFn read16 = nullptr;
+  WriteHalfFn write16 = nullptr;
+
+  // Only set for registers which must be accessed as a whole by 32-bit accesses.
+  ReadWordFn read32 = nullptr;
+  WriteWordFn write32 = nullptr;
+
+  // Bits of a write which are backed by the register, so that handlers which store the value directly do not need to mask it.
+  u16 write_mask = 0xFFFF;
+};
+
+constexpr u32 kIORegisterCount = 0x200;
+
+constexpr auto BuildIORegisterTable() -> std::array<IORegister, kIORegisterCount> {
+  std::array<IORegister, kIORegisterCount> registers{};
+
+  auto reg = [&](u32 address) -> IORegister& {
+    return registers[(address & 0x3FF) >> 1];
+  };
+
+  // PPU
+  reg(DISPCNT) = {
+    [](Hardware& hw, u32) -> u16 { return hw.ppu.mmio.dispcnt.ReadHalf(); },
+    [](Hardware& hw, u32, u16 value) { hw.ppu.mmio.dispcnt.WriteHalf(value); }
+  };
+  reg(DISPSTAT) = {
+    [](Hardware& hw, u32) -> u16 { return hw.ppu.mmio.dispstat.ReadHalf(); },
+    [](Hardware& hw, u32, u16 value) { hw.ppu.mmio.dispstat.WriteHalf(value); }
+  };
+
+  for(u32 id = 0; id < 4; id++) {
+    reg(BG0CNT + id * 2) = {
+      [](Hardware& hw, u32 address) -> u16 { return hw.ppu.mmio.bgcnt[(address - BG0CNT) >> 1].ReadHalf(); },
+      [](Hardware& hw, u32 address, u16 value) { hw.ppu.mmio.bgcnt[(address - BG0CNT) >> 1].WriteHalf(value); }
+    };
+
+    reg(BG0HOFS + id * 4).write16 = [](Hardware& hw, u32 address, u16 value) { hw.ppu.mmio.bghofs[(address - BG0HOFS) >> 2] = value; };
+    reg(BG0HOFS + id * 4).write_mask = 0x01FF;
+    reg(BG0VOFS + id * 4).write16 = [](Hardware& hw, u32 address, u16 value) { hw.ppu.mmio.bgvofs[(address - BG0VOFS) >> 2] = value; };
+    reg(BG0VOFS + id * 4).write_mask = 0x01FF;
+  }
+
+  for(u32 id = 0; id < 2; id++) {
+    reg(BG2PA + id * 16).write16 = [](Hardware& hw, u32 address, u16 value) { hw.ppu.mmio.bgpa[(address - BG2PA) >> 4] = (s16)value; };
+    reg(BG2PB + id * 16).write16 = [](Hardware& hw, u32 address, u16 value) { hw.ppu.mmio.bgpb[(address - BG2PB) >> 4] = (s16)value; };
+    reg(BG2PC + id * 16).write16 = [](Hardware& hw, u32 address, u16 value) { hw.ppu.mmio.bgpc[(address - BG2PC) >> 4] = (s16)value; };
+    reg(BG2PD + id * 16).write16 = [](Hardware& hw, u32 address, u16 value) { hw.ppu.mmio.bgpd[(address - BG2PD) >> 4] = (s16)value; };
+
+    for(u32 offset = 0; offset < 4; offset += 2) {
+      reg(BG2X + id * 16 + offset).write16 = [](Hardware& hw, u32 address, u16 value) { hw.ppu.mmio.bgx[(address - BG2X) >> 4].WriteHalf(address & 2, value); };
+      reg(BG2Y + id * 16 + offset).write16 = [](Hardware& hw, u32 address, u16 value) { hw.ppu.mmio.bgy[(address - BG2Y) >> 4].WriteHalf(address & 2, value); };
+    }
+
+    reg(BG2X + id * 16).write32 = [](Hardware& hw, u32 address, u32 value) { hw.ppu.mmio.bgx[(address - BG2X) >> 4].WriteWord(value); };
+    reg(BG2Y + id * 16).write32 = [](Hardware& hw, u32 address, u32 value) { hw.ppu.mmio.bgy[(address - BG2Y) >> 4].WriteWord(value); };
+  }
+
+  for(u32 id = 0; id < 2; id++) {
+    reg(WIN0H + id * 2).write16 = [](Hardware& hw, u32 address, u16 value) { hw.ppu.mmio.winh[(address - WIN0H) >> 1].WriteHalf(value); };
+    reg(WIN0V + id * 2).write16 = [](Hardware& hw, u32 address, u16 value) { hw.ppu.mmio.winv[(address - WIN0V) >> 1].WriteHalf(value); };
+  }
+
+  reg(WININ) = {
+    [](Hardware& hw, u32) -> u16 { return hw.ppu.mmio.winin.ReadHalf(); },
+    [](Hardware& hw, u32, u16 value) { hw.ppu.mmio.winin.WriteHalf(value); }
+  };
+  reg(WINOUT) = {
+    [](Hardware& hw, u32) -> u16 { return hw.ppu.mmio.winout.ReadHalf(); },
+    [](Hardware& hw, u32, u16 value) { hw.ppu.mmio.winout.WriteHalf(value); }
+  };
+  reg(MOSAIC).write16 = [](Hardware& hw, u32, u16 value) { hw.ppu.mmio.mosaic.WriteHalf(value); };
+  reg(BLDCNT) = {
+    [](Hardware& hw, u32) -> u16 { return hw.ppu.mmio.bldcnt.ReadHalf(); },
+    [](Hardware& hw, u32, u16 value) { hw.ppu.mmio.bldcnt.WriteHalf(value); }
+  };
+  reg(BLDALPHA).write16 = [](Hardware& hw, u32, u16 value) {
+    hw.ppu.mmio.eva = value & 0xFF;
+    hw.ppu.mmio.evb = value >> 8;
+  };
+  reg(BLDALPHA).write_mask = 0x1F1F;
+  reg(BLDY).write16 = [](Hardware& hw, u32, u16 value) { hw.ppu.mmio.evy = value; };
+  reg(BLDY).write_mask = 0x001F;
+
+  // DMA 0 - 3
+  for(u32 id = 0; id < 4; id++) {
+    const u32 base = DMA0SAD + id * 12;
+
+    for(u32 offset = 0; offset < 12; offset += 2) {
+      reg(base + offset).write16 = [](Hardware& hw, u32 address, u16 value) {
+        hw.dma.WriteHalf((address - DMA0SAD) / 12, (address - DMA0SAD) % 12, value);
+      };
+    }
+
+    for(u32 offset = 0; offset < 12; offset += 4) {
+      reg(base + offset).write32 = [](Hardware& hw, u32 address, u32 value) {
+        hw.dma.WriteWord((address - DMA0SAD) / 12, (address - DMA0SAD) % 12, value);
+      };
+    }
+
+    reg(base + 10).read16 = [](Hardware& hw, u32 address) -> u16 { return hw.dma.ReadHalf((address - DMA0SAD) / 12, 10); };
+  }
+
+  // Sound
+  for(u32 id = 0; id < 2; id++) {
+    const u32 base = FIFO_A + id * 4;
+
+    for(u32 offset = 0; offset < 4; offset += 2) {
+      reg(base + offset).write16 = [](Hardware& hw, u32 address, u16 value) {
+        if(hw.apu.mmio.soundcnt.master_enable) {
+          hw.apu.mmio.fifo[(address - FIFO_A) >> 2].WriteHalf(address & 2, value);
+        }
+      };
+    }
+
+    reg(base).write32 = [](Hardware& hw, u32 address, u32 value) {
+      if(hw.apu.mmio.soundcnt.master_enable) {
+        hw.apu.mmio.fifo[(address - FIFO_A) >> 2].WriteWord(value);
+      }
+    };
+  }
+
+  // Timer 0 - 3
+  for(u32 id = 0; id < 4; id++) {
+    reg(TM0CNT_L + id * 4) = {
+      [](Hardware& hw, u32 address) -> u16 { return hw.timer.ReadHalf((address - TM0CNT_L) >> 2, 0); },
+      [](Hardware& hw, u32 address, u16 value) { hw.timer.WriteHalf((address - TM0CNT_L) >> 2, 0, value); },
+      [](Hardware& hw, u32 address) -> u32 { return hw.timer.ReadWord((address - TM0CNT_L) >> 2); },
+      [](Hardware& hw, u32 address, u32 value) { hw.timer.WriteWord((address - TM0CNT_L) >> 2, value); }
+    };
+    reg(TM0CNT_H + id * 4) = {
+      [](Hardware& hw, u32 address) -> u16 { return hw.timer.ReadHalf((address - TM0CNT_H) >> 2, 2); },
+      [](Hardware& hw, u32 address, u16 value) { hw.timer.WriteHalf((address - TM0CNT_H) >> 2, 2, value); }
+    };
+  }
+
+  // Serial communication
+  reg(SIOCNT).write16 = [](Hardware& hw, u32, u16 value) {
+    hw.siocnt = (hw.siocnt & 0x80u) | (value & ~0x80u);
+
+    if(!(hw.siocnt & 0x80u) && value & 0x80u) {
+      // bit 0 (from bit  1): internal shift clock (0 = 256 KHz, 1 = 2 MHz)
+      // bit 1 (from bit 12): transfer length (0 = 8-bit, 1 = 32-bit)
+      constexpr int table[4] {
+        512,
+        64,
+        2048,
+        256
+      };
+
+      hw.siocnt |= 0x80u;
+
+      const int cycles = table[((hw.siocnt >> 1) & 1u) | ((hw.siocnt >> 11) & 2u)];
+
+      hw.bus->scheduler.Add(cycles, Scheduler::EventClass::SIO_transfer_done);
+    }
+  };
+
+  /* Do not invoke Keypad::UpdateIRQ() twice for a single 16-bit write.
+   * See https://github.com/fleroviux/NanoBoyAdvance/issues/152 for details.
+   */
+  reg(KEYCNT).write16 = [](Hardware& hw, u32, u16 value) { hw.keypad.control.WriteHalf(value); };
+
+  // IRQ controller
+  reg(IE) = {
+    [](Hardware& hw, u32) -> u16 { return hw.irq.ReadHalf(0); },
+    [](Hardware& hw, u32, u16 value) { hw.irq.WriteHalf(0, value); }
+  };
+  reg(IF) = {
+    [](Hardware& hw, u32) -> u16 { return hw.irq.ReadHalf(2); },
+    [](Hardware& hw, u32, u16 value) { hw.irq.WriteHalf(2, value); }
+  };
+  reg(IME).read16 = [](Hardware& hw, u32) -> u16 { return hw.irq.ReadHalf(4); };
+
+  return registers;
+}
+
+constexpr auto kIORegisterTable = BuildIORegisterTable();
+
+auto GetIORegister(u32 address) -> IORegister const* {
+  if(address >= DISPCNT + kIORegisterCount * sizeof(u16)) {
+    return nullptr;
+  }
+  return &kIORegisterTable[(address & 0x3FF) >> 1];
+}
+
+} // anonymous namespace
+
 auto Bus::Hardware::ReadByte(u32 address) ->  u8 {
   auto& apu_io = apu.mmio;
   auto& ppu_io = ppu.mmio;
@@ -203,32 +406,20 @@ auto Bus::Hardware::ReadByte(u32 address) ->  u8 {
 }
 
 auto Bus::Hardware::ReadHalf(u32 address) -> u16 {
-  switch(address) {
-    // Timer 0 - 3
-    case TM0CNT_L: return timer.ReadHalf(0, 0);
-    case TM0CNT_H: return timer.ReadHalf(0, 2);
-    case TM1CNT_L: return timer.ReadHalf(1, 0);
-    case TM1CNT_H: return timer.ReadHalf(1, 2);
-    case TM2CNT_L: return timer.ReadHalf(2, 0);
-    case TM2CNT_H: return timer.ReadHalf(2, 2);
-    case TM3CNT_L: return timer.ReadHalf(3, 0);
-    case TM3CNT_H: return timer.ReadHalf(3, 2);
+  auto reg = GetIORegister(address);
 
-    // IRQ controller
-    case IE:  return irq.ReadHalf(0);
-    case IF:  return irq.ReadHalf(2);
-    case IME: return irq.ReadHalf(4);
+  if(reg && reg->read16) {
+    return reg->read16(*this, address);
   }
 
   return ReadByte(address) | (ReadByte(address + 1) << 8);
 }
 
 auto Bus::Hardware::ReadWord(u32 address) -> u32 {
-  switch(address) {
-    case TM0CNT_L: return timer.ReadWord(0);
-    case TM1CNT_L: return timer.ReadWord(1);
-    case TM2CNT_L: return timer.ReadWord(2);
-    case TM3CNT_L: return timer.ReadWord(3);
+  auto reg = GetIORegister(address);
+
+  if(reg && reg->read32) {
+    return reg->read32(*this, address);
   }
 
   return ReadHalf(address) | (ReadHalf(address + 2) << 16);
@@ -256,94 +447,30 @@ void Bus::Hardware::WriteByte(u32 address,  u8 value) {
     case BG2CNT+1:   ppu_io.bgcnt[2].Write(1, value); break;
     case BG3CNT+0:   ppu_io.bgcnt[3].Write(0, value); break;
     case BG3CNT+1:   ppu_io.bgcnt[3].Write(1, value); break;
-    case BG0HOFS+0: {
-      ppu_io.bghofs[0] &= 0xFF00;
-      ppu_io.bghofs[0] |= value;
-      break;
-    }
-    case BG0HOFS+1: {
-      ppu_io.bghofs[0] &= 0x00FF;
-      ppu_io.bghofs[0] |= (value & 1) << 8;
-      break;
-    }
-    case BG0VOFS+0: {
-      ppu_io.bgvofs[0] &= 0xFF00;
-      ppu_io.bgvofs[0] |= value;
-      break;
-    }
-    case BG0VOFS+1: {
-      ppu_io.bgvofs[0] &= 0x00FF;
-      ppu_io.bgvofs[0] |= (value & 1) << 8;
-      break;
-    }
-    case BG1HOFS+0: {
-      ppu_io.bghofs[1] &= 0xFF00;
-      ppu_io.bghofs[1] |= value;
-      break;
-    }
-    case BG1HOFS+1: {
-      ppu_io.bghofs[1] &= 0x00FF;
-      ppu_io.bghofs[1] |= (value & 1) << 8;
-      break;
-    }
-    case BG1VOFS+0: {
-      ppu_io.bgvofs[1] &= 0xFF00;
-      ppu_io.bgvofs[1] |= value;
-      break;
-    }
-    case BG1VOFS+1: {
-      ppu_io.bgvofs[1] &= 0x00FF;
-      ppu_io.bgvofs[1] |= (value & 1) << 8;
-      break;
-    }
-    case BG2HOFS+0: {
-      ppu_io.bghofs[2] &= 0xFF00;
-      ppu_io.bghofs[2] |= value;
-      break;
-    }
-    case BG2HOFS+1: {
-      ppu_io.bghofs[2] &= 0x00FF;
-      ppu_io.bghofs[2] |= (value & 1) << 8;
-      break;
-    }
-    case BG2VOFS+0: {
-      ppu_io.bgvofs[2] &= 0xFF00;
-      ppu_io.bgvofs[2] |= value;
-      break;
-    }
-    case BG2VOFS+1: {
-      ppu_io.bgvofs[2] &= 0x00FF;
-      ppu_io.bgvofs[2] |= (value & 1) << 8;
-      break;
-    }
-    case BG3HOFS+0: {
-      ppu_io.bghofs[3] &= 0xFF00;
-      ppu_io.bghofs[3] |= value;
-      break;
-    }
-    case BG3HOFS+1: {
-      ppu_io.bghofs[3] &= 0x00FF;
-      ppu_io.bghofs[3] |= (value & 1) << 8;
-      break;
-    }
-    case BG3VOFS+0: {
-      ppu_io.bgvofs[3] &= 0xFF00;
-      ppu_io.bgvofs[3] |= value;
-      break;
-    }
-    case BG3VOFS+1: {
-      ppu_io.bgvofs[3] &= 0x00FF;
-      ppu_io.bgvofs[3] |= (value & 1) << 8;
-      break;
-    }
-    case BG2PA:   ppu_io.bgpa[0] = (ppu_io.bgpa[0] & 0xFF00) | (value << 0); break;
-    case BG2PA+1: ppu_io.bgpa[0] = (ppu_io.bgpa[0] & 0x00FF) | (value << 8); break;
-    case BG2PB:   ppu_io.bgpb[0] = (ppu_io.bgpb[0] & 0xFF00) | (value << 0); break;
-    case BG2PB+1: ppu_io.bgpb[0] = (ppu_io.bgpb[0] & 0x00FF) | (value << 8); break;
-    case BG2PC:   ppu_io.bgpc[0] = (ppu_io.bgpc[0] & 0xFF00) | (value << 0); break;
-    case BG2PC+1: ppu_io.bgpc[0] = (ppu_io.bgpc[0] & 0x00FF) | (value << 8); break;
-    case BG2PD:   ppu_io.bgpd[0] = (ppu_io.bgpd[0] & 0xFF00) | (value << 0); break;
-    case BG2PD+1: ppu_io.bgpd[0] = (ppu_io.bgpd[0] & 0x00FF) | (value << 8); break;
+    case BG0HOFS+0: WriteHalf(BG0HOFS, (ppu_io.bghofs[0] & 0xFF00) | (value << 0)); break;
+    case BG0HOFS+1: WriteHalf(BG0HOFS, (ppu_io.bghofs[0] & 0x00FF) | (value << 8)); break;
+    case BG0VOFS+0: WriteHalf(BG0VOFS, (ppu_io.bgvofs[0] & 0xFF00) | (value << 0)); break;
+    case BG0VOFS+1: WriteHalf(BG0VOFS, (ppu_io.bgvofs[0] & 0x00FF) | (value << 8)); break;
+    case BG1HOFS+0: WriteHalf(BG1HOFS, (ppu_io.bghofs[1] & 0xFF00) | (value << 0)); break;
+    case BG1HOFS+1: WriteHalf(BG1HOFS, (ppu_io.bghofs[1] & 0x00FF) | (value << 8)); break;
+    case BG1VOFS+0: WriteHalf(BG1VOFS, (ppu_io.bgvofs[1] & 0xFF00) | (value << 0)); break;
+    case BG1VOFS+1: WriteHalf(BG1VOFS, (ppu_io.bgvofs[1] & 0x00FF) | (value << 8)); break;
+    case BG2HOFS+0: WriteHalf(BG2HOFS, (ppu_io.bghofs[2] & 0xFF00) | (value << 0)); break;
+    case BG2HOFS+1: WriteHalf(BG2HOFS, (ppu_io.bghofs[2] & 0x00FF) | (value << 8)); break;
+    case BG2VOFS+0: WriteHalf(BG2VOFS, (ppu_io.bgvofs[2] & 0xFF00) | (value << 0)); break;
+    case BG2VOFS+1: WriteHalf(BG2VOFS, (ppu_io.bgvofs[2] & 0x00FF) | (value << 8)); break;
+    case BG3HOFS+0: WriteHalf(BG3HOFS, (ppu_io.bghofs[3] & 0xFF00) | (value << 0)); break;
+    case BG3HOFS+1: WriteHalf(BG3HOFS, (ppu_io.bghofs[3] & 0x00FF) | (value << 8)); break;
+    case BG3VOFS+0: WriteHalf(BG3VOFS, (ppu_io.bgvofs[3] & 0xFF00) | (value << 0)); break;
+    case BG3VOFS+1: WriteHalf(BG3VOFS, (ppu_io.bgvofs[3] & 0x00FF) | (value << 8)); break;
+    case BG2PA:   WriteHalf(BG2PA, (ppu_io.bgpa[0] & 0xFF00) | (value << 0)); break;
+    case BG2PA+1: WriteHalf(BG2PA, (ppu_io.bgpa[0] & 0x00FF) | (value << 8)); break;
+    case BG2PB:   WriteHalf(BG2PB, (ppu_io.bgpb[0] & 0xFF00) | (value << 0)); break;
+    case BG2PB+1: WriteHalf(BG2PB, (ppu_io.bgpb[0] & 0x00FF) | (value << 8)); break;
+    case BG2PC:   WriteHalf(BG2PC, (ppu_io.bgpc[0] & 0xFF00) | (value << 0)); break;
+    case BG2PC+1: WriteHalf(BG2PC, (ppu_io.bgpc[0] & 0x00FF) | (value << 8)); break;
+    case BG2PD:   WriteHalf(BG2PD, (ppu_io.bgpd[0] & 0xFF00) | (value << 0)); break;
+    case BG2PD+1: WriteHalf(BG2PD, (ppu_io.bgpd[0] & 0x00FF) | (value << 8)); break;
     case BG2X:    ppu_io.bgx[0].Write(0, value); break;
     case BG2X+1:  ppu_io.bgx[0].Write(1, value); break;
     case BG2X+2:  ppu_io.bgx[0].Write(2, value); break;
@@ -352,14 +479,14 @@ void Bus::Hardware::WriteByte(u32 address,  u8 value) {
     case BG2Y+1:  ppu_io.bgy[0].Write(1, value); break;
     case BG2Y+2:  ppu_io.bgy[0].Write(2, value); break;
     case BG2Y+3:  ppu_io.bgy[0].Write(3, value); break;
-    case BG3PA:   ppu_io.bgpa[1] = (ppu_io.bgpa[1] & 0xFF00) | (value << 0); break;
-    case BG3PA+1: ppu_io.bgpa[1] = (ppu_io.bgpa[1] & 0x00FF) | (value << 8); break;
-    case BG3PB:   ppu_io.bgpb[1] = (ppu_io.bgpb[1] & 0xFF00) | (value << 0); break;
-    case BG3PB+1: ppu_io.bgpb[1] = (ppu_io.bgpb[1] & 0x00FF) | (value << 8); break;
-    case BG3PC:   ppu_io.bgpc[1] = (ppu_io.bgpc[1] & 0xFF00) | (value << 0); break;
-    case BG3PC+1: ppu_io.bgpc[1] = (ppu_io.bgpc[1] & 0x00FF) | (value << 8); break;
-    case BG3PD:   ppu_io.bgpd[1] = (ppu_io.bgpd[1] & 0xFF00) | (value << 0); break;
-    case BG3PD+1: ppu_io.bgpd[1] = (ppu_io.bgpd[1] & 0x00FF) | (value << 8); break;
+    case BG3PA:   WriteHalf(BG3PA, (ppu_io.bgpa[1] & 0xFF00) | (value << 0)); break;
+    case BG3PA+1: WriteHalf(BG3PA, (ppu_io.bgpa[1] & 0x00FF) | (value << 8)); break;
+    case BG3PB:   WriteHalf(BG3PB, (ppu_io.bgpb[1] & 0xFF00) | (value << 0)); break;
+    case BG3PB+1: WriteHalf(BG3PB, (ppu_io.bgpb[1] & 0x00FF) | (value << 8)); break;
+    case BG3PC:   WriteHalf(BG3PC, (ppu_io.bgpc[1] & 0xFF00) | (value << 0)); break;
+    case BG3PC+1: WriteHalf(BG3PC, (ppu_io.bgpc[1] & 0x00FF) | (value << 8)); break;
+    case BG3PD:   WriteHalf(BG3PD, (ppu_io.bgpd[1] & 0xFF00) | (value << 0)); break;
+    case BG3PD+1: WriteHalf(BG3PD, (ppu_io.bgpd[1] & 0x00FF) | (value << 8)); break;
     case BG3X:    ppu_io.bgx[1].Write(0, value); break;
     case BG3X+1:  ppu_io.bgx[1].Write(1, value); break;
     case BG3X+2:  ppu_io.bgx[1].Write(2, value); break;
@@ -384,9 +511,9 @@ void Bus::Hardware::WriteByte(u32 address,  u8 value) {
     case MOSAIC+1: ppu_io.mosaic.Write(1, value); break;
     case BLDCNT+0: ppu_io.bldcnt.Write(0, value); break;
     case BLDCNT+1: ppu_io.bldcnt.Write(1, value); break;
-    case BLDALPHA+0: ppu_io.eva = value & 0x1F; break;
-    case BLDALPHA+1: ppu_io.evb = value & 0x1F; break;
-    case BLDY: ppu_io.evy = value & 0x1F; break;
+    case BLDALPHA+0: WriteHalf(BLDALPHA, (ppu_io.evb << 8) | (value << 0)); break;
+    case BLDALPHA+1: WriteHalf(BLDALPHA, (ppu_io.eva << 0) | (value << 8)); break;
+    case BLDY: WriteHalf(BLDY, value); break;
 
     // DMA 0 - 3
     case DMA0SAD:     dma.Write(0, 0, value); break;
@@ -575,62 +702,14 @@ void Bus::Hardware::WriteByte(u32 address,  u8 value) {
 }
 
 void Bus::Hardware::WriteHalf(u32 address, u16 value) {
-  auto& apu_io = apu.mmio;
+  auto reg = GetIORegister(address);
 
-  const bool apu_enable = apu_io.soundcnt.master_enable;
+  if(reg && reg->write16) {
+    reg->write16(*this, address, value & reg->write_mask);
+    return;
+  }
 
   switch(address) {
-    case FIFO_A+0: if(apu_enable) apu_io.fifo[0].WriteHalf(0, value); break;
-    case FIFO_A+2: if(apu_enable) apu_io.fifo[0].WriteHalf(2, value); break;
-    case FIFO_B+0: if(apu_enable) apu_io.fifo[1].WriteHalf(0, value); break;
-    case FIFO_B+2: if(apu_enable) apu_io.fifo[1].WriteHalf(2, value); break;
-
-    // Timers 0 - 3
-    case TM0CNT_L: timer.WriteHalf(0, 0, value); break;
-    case TM0CNT_H: timer.WriteHalf(0, 2, value); break;
-    case TM1CNT_L: timer.WriteHalf(1, 0, value); break;
-    case TM1CNT_H: timer.WriteHalf(1, 2, value); break;
-    case TM2CNT_L: timer.WriteHalf(2, 0, value); break;
-    case TM2CNT_H: timer.WriteHalf(2, 2, value); break;
-    case TM3CNT_L: timer.WriteHalf(3, 0, value); break;
-    case TM3CNT_H: timer.WriteHalf(3, 2, value); break;
-
-    /* Do not invoke Keypad::UpdateIRQ() twice for a single 16-bit write.
-     * See https://github.com/fleroviux/NanoBoyAdvance/issues/152 for details.
-     */
-    case KEYCNT: {
-      keypad.control.WriteHalf(value);
-      break;
-    }
-
-    // IRQ controller
-    case IE:  irq.WriteHalf(0, value); break;
-    case IF:  irq.WriteHalf(2, value); break;
-    case IME: irq.WriteByte(4, value); break;
-
-    case SIOCNT: {
-      siocnt = (siocnt & 0x80u) | (value & ~0x80u);
-
-      if(!(siocnt & 0x80u) && value & 0x80u) {
-        // bit 0 (from bit  1): internal shift clock (0 = 256 KHz, 1 = 2 MHz)
-        // bit 1 (from bit 12): transfer length (0 = 8-bit, 1 = 32-bit)
-        static const int table[4] {
-          512,
-          64,
-          2048,
-          256
-        };
-
-        siocnt |= 0x80u;
-
-        const int cycles = table[((siocnt >> 1) & 1u) | ((siocnt >> 11) & 2u)];
-
-        bus->scheduler.Add(cycles, Scheduler::EventClass::SIO_transfer_done);
-      }
-
-      break;
-    }
-
     case MGBA_LOG_SEND: {
       if(mgba_log.enable && (value & 0x100) != 0) {
         fmt::print("mGBA log: {}\n", mgba_log.message.data());
@@ -655,26 +734,15 @@ void Bus::Hardware::WriteHalf(u32 address, u16 value) {
 }
 
 void Bus::Hardware::WriteWord(u32 address, u32 value) {
-  auto& apu_io = apu.mmio;
-
-  const bool apu_enable = apu_io.soundcnt.master_enable;
-
-  switch(address) {
-    case FIFO_A: if(apu_enable) apu_io.fifo[0].WriteWord(value); break;
-    case FIFO_B: if(apu_enable) apu_io.fifo[1].WriteWord(value); break;
+  auto reg = GetIORegister(address);
 
-    // Timers 0 - 3
-    case TM0CNT_L: timer.WriteWord(0, value); break;
-    case TM1CNT_L: timer.WriteWord(1, value); break;
-    case TM2CNT_L: timer.WriteWord(2, value); break;
-    case TM3CNT_L: timer.WriteWord(3, value); break;
-
-    default: {
-      WriteHalf(address + 0, u16(value >> 0));
-      WriteHalf(address + 2, u16(value >> 16));
-      break;
-    }
+  if(reg && reg->write32) {
+    reg->write32(*this, address, value & (reg[0].write_mask | ((u32)reg[1].write_mask << 16)));
+    return;
   }
+
+  WriteHalf(address + 0, u16(value >> 0));
+  WriteHalf(address + 2, u16(value >> 16));
 }
 
 void Bus::SIOTransferDone() {
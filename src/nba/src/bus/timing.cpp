@@ -135,6 +135,36 @@ void Bus::Step(int cycles) {
   }
 }
 
+/* Accounts for a DMA burst of count (half)word transfers between EWRAM, IWRAM and ROM,
+ * which the DMA has copied in one go. This is equivalent to a Step() call for each access.
+ */
+void Bus::StepBurst(int read_cycles, int write_cycles, int count) {
+  /* Once the prefetch buffer cannot make progress anymore, each Step() call only increments its count.
+   * Until then the accesses have to be stepped one by one.
+   */
+  while(count > 0 && prefetch.active && prefetch.countdown > 0) {
+    Step(read_cycles);
+    Step(write_cycles);
+    count--;
+  }
+
+  if(count > 0) {
+    const int cycles = (read_cycles + write_cycles) * count;
+
+    scheduler.AddCycles(cycles);
+
+    if(prefetch.active) {
+      prefetch.countdown -= cycles;
+      prefetch.count += count * 2;
+    }
+  }
+
+  if(idle_loop_monitor.enabled) idle_loop_monitor.side_effects = true;
+
+  parallel_internal_cpu_cycle_limit = 0;
+  last_access = Sequential | Dma;
+}
+
 void Bus::UpdateWaitStateTable() {
   static constexpr int nseq[4] = { 5, 4, 3, 9 };
   static constexpr int seq0[2] = { 3, 2 };
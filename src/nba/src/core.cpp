@@ -5,6 +5,8 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
+#include <cstring>
 #include <nba/common/crc32.hpp>
 #include <nba/rom/gpio/rtc.hpp>
 #include <nba/rom/gpio/solar_sensor.hpp>
@@ -24,7 +26,8 @@ Core::Core(std::shared_ptr<Config> config)
     , ppu(scheduler, irq, dma, config)
     , timer(scheduler, irq, apu)
     , keypad(scheduler, irq)
-    , bus(scheduler, {cpu, irq, dma, apu, ppu, timer, keypad}) {
+    , bus(scheduler, {cpu, irq, dma, apu, ppu, timer, keypad})
+    , hle_bios(cpu, bus) {
   Reset();
 }
 
@@ -39,24 +42,53 @@ void Core::Reset() {
   bus.Reset();
   keypad.Reset();
 
+  RemovePCHook(hle_audio_hook);
+  RemovePCHook(hle_bios_hook);
+  hle_audio_hook = -1;
+  hle_bios_hook = -1;
+
+  if(config->hle_bios) {
+    if(!bios_attached) {
+      bus.Attach(HLEBIOS::GetStubBIOS());
+    }
+
+    hle_bios.UsingStubBIOS() = !bios_attached;
+    hle_bios_hook = AddPCHook(HLEBIOS::kSWIVector, [this](u32) {
+      hle_bios.HandleSWI();
+    });
+  }
+
   if(config->skip_bios) {
     SkipBootScreen();
   }
 
+  skip_idle_loops = config->skip_idle_loops;
+  ResetIdleLoopDetection();
+
   if(config->audio.mp2k_hle_enable) {
     apu.GetMP2K().UseCubicFilter() = config->audio.mp2k_hle_cubic;
     apu.GetMP2K().ForceReverb() = config->audio.mp2k_hle_force_reverb;
-    hle_audio_hook = SearchSoundMainRAM();
-    if(hle_audio_hook != 0xFFFFFFFF) {
-      Log<Info>("Core: detected MP2K audio mixer @ 0x{:08X}", hle_audio_hook);
+
+    const u32 sound_main_ram = SearchSoundMainRAM();
+
+    if(sound_main_ram != 0xFFFFFFFF) {
+      Log<Info>("Core: detected MP2K audio mixer @ 0x{:08X}", sound_main_ram);
+
+      hle_audio_hook = AddPCHook(sound_main_ram, [this](u32) {
+        const u32  sound_info_addr = *bus.GetHostAddress<u32>(0x03007FF0);
+        const auto sound_info = bus.GetHostAddress<MP2K::SoundInfo>(sound_info_addr);
+
+        if(sound_info != nullptr) {
+          apu.GetMP2K().SoundMainRAM(*sound_info);
+        }
+      });
     }
-  } else {
-    hle_audio_hook = 0xFFFFFFFF;
   }
 }
 
 void Core::Attach(std::vector<u8> const& bios) {
   bus.Attach(bios);
+  bios_attached = true;
 }
 
 void Core::Attach(ROM&& rom) {
@@ -82,16 +114,18 @@ void Core::Run(int cycles) {
 
   while(scheduler.GetTimestampNow() < limit) {
     if(bus.hw.haltcnt == HaltControl::Run) {
-      if(cpu.state.r15 == hle_audio_hook) {
-        const u32  sound_info_addr = *bus.GetHostAddress<u32>(0x03007FF0);
-        const auto sound_info = bus.GetHostAddress<MP2K::SoundInfo>(sound_info_addr);
-
-        if(sound_info != nullptr) {
-          apu.GetMP2K().SoundMainRAM(*sound_info);
-        }
+      if(cpu.PCHookPending()) [[unlikely]] {
+        DispatchPCHooks();
+        continue;
       }
 
+      const u32 r15 = cpu.state.r15;
+
       cpu.Run();
+
+      if(skip_idle_loops && cpu.state.r15 < r15 && r15 - cpu.state.r15 <= kIdleLoopMaxSize) {
+        DetectIdleLoop(limit);
+      }
     } else {
       while(scheduler.GetTimestampNow() < limit && !irq.ShouldUnhaltCPU()) {
         if(dma.IsRunning()) {
@@ -110,6 +144,154 @@ void Core::Run(int cycles) {
   }
 }
 
+auto Core::AddPCHook(u32 address, PCHook hook) -> int {
+  const int handle = next_pc_hook_handle++;
+
+  pc_hooks.push_back({handle, address, std::move(hook)});
+  cpu.PCHookBitmap().Set(address, true);
+  return handle;
+}
+
+void Core::RemovePCHook(int handle) {
+  auto match = std::find_if(pc_hooks.begin(), pc_hooks.end(), [&](PCHookEntry const& entry) {
+    return entry.handle == handle;
+  });
+
+  if(match == pc_hooks.end()) {
+    return;
+  }
+
+  const u32 address = match->address;
+
+  pc_hooks.erase(match);
+
+  const bool address_has_hooks = std::any_of(pc_hooks.begin(), pc_hooks.end(), [&](PCHookEntry const& entry) {
+    return entry.address == address;
+  });
+
+  if(!address_has_hooks) {
+    cpu.PCHookBitmap().Set(address, false);
+  }
+}
+
+void Core::DispatchPCHooks() {
+  const u32 r15 = cpu.state.r15;
+  const u32 address = r15 - (cpu.state.cpsr.f.thumb ? sizeof(u16) : sizeof(u32)) * 2;
+
+  cpu.PCHookPending() = false;
+
+  // Hooks may write to memory without going through the bus.
+  bus.idle_loop_monitor.side_effects = true;
+
+  for(auto& entry : pc_hooks) {
+    if(entry.address == address) {
+      entry.hook(address);
+
+      // Once a hook made the CPU jump elsewhere, the hooks of the new address are due instead.
+      if(cpu.state.r15 != r15) {
+        break;
+      }
+    }
+  }
+}
+
+void Core::ResetIdleLoopDetection() {
+  idle_loops.fill({});
+  idle_loop_candidate.active = false;
+  bus.idle_loop_monitor = {};
+}
+
+/* Called after a short backward branch. Idle loops are loops which only poll memory
+ * and hardware registers that do not change until the next scheduler event.
+ * If a loop iteration did not access anything else, no event happened during it and the
+ * CPU ended up in the exact same state as before the iteration, then every following
+ * iteration will do the same, at least until the next event. Those iterations are skipped
+ * by advancing the time by a multiple of the iteration length, so the result is identical.
+ */
+void Core::DetectIdleLoop(u64 limit) {
+  const u32 address = cpu.state.r15;
+  const u64 timestamp = scheduler.GetTimestampNow();
+
+  auto& idle_loop = idle_loops[(address >> 1) & (idle_loops.size() - 1)];
+  auto& candidate = idle_loop_candidate;
+
+  if(idle_loop.address != address) {
+    idle_loop = {address, 0, false, 0};
+  } else if(idle_loop.rejected) {
+    if(timestamp < idle_loop.timestamp_retry) {
+      return;
+    }
+
+    idle_loop.rejected = false;
+    idle_loop.mismatches = 0;
+  }
+
+  // Only judge the iteration if no event happened during it, because events may change anything.
+  if(candidate.active && candidate.address == address && timestamp < candidate.timestamp_target) {
+    const bool same_state = IsSameIdleLoopState();
+
+    /* Loops with side effects are never idle. A different state may be caused by a loop counter,
+     * but also by the prefetch buffer still settling in, so only repeated mismatches reject a loop.
+     */
+    if(bus.idle_loop_monitor.side_effects || (!same_state && ++idle_loop.mismatches == kIdleLoopMaxMismatches)) {
+      idle_loop.rejected = true;
+      idle_loop.timestamp_retry = timestamp + kIdleLoopRetryCycles;
+      candidate.active = false;
+      bus.idle_loop_monitor.enabled = false;
+      return;
+    }
+
+    if(same_state) {
+      idle_loop.mismatches = 0;
+
+      const u64 cycles = timestamp - candidate.timestamp;
+      const u64 timestamp_end = std::min(scheduler.GetTimestampTarget() - 1, limit);
+
+      if(cycles != 0 && timestamp_end > timestamp) {
+        scheduler.AddCycles(int((timestamp_end - timestamp) / cycles * cycles));
+      }
+    }
+  }
+
+  // A DMA which is about to run would write to memory during the iteration.
+  if(dma.IsRunning()) {
+    candidate.active = false;
+    bus.idle_loop_monitor.enabled = false;
+    return;
+  }
+
+  candidate.active = true;
+  candidate.address = address;
+  candidate.timestamp = scheduler.GetTimestampNow();
+  candidate.timestamp_target = scheduler.GetTimestampTarget();
+  candidate.regs = cpu.state;
+  candidate.prefetch = bus.prefetch;
+  candidate.last_access = bus.last_access;
+  candidate.parallel_internal_cpu_cycle_limit = bus.parallel_internal_cpu_cycle_limit;
+  candidate.bios_latch = bus.memory.latch.bios;
+
+  bus.idle_loop_monitor = {true, false};
+}
+
+bool Core::IsSameIdleLoopState() const {
+  auto& candidate = idle_loop_candidate;
+  auto& prefetch = bus.prefetch;
+
+  return std::memcmp(&candidate.regs, &cpu.state, sizeof(cpu.state)) == 0 &&
+         candidate.prefetch.active == prefetch.active &&
+         candidate.prefetch.head_address == prefetch.head_address &&
+         candidate.prefetch.last_address == prefetch.last_address &&
+         candidate.prefetch.count == prefetch.count &&
+         candidate.prefetch.capacity == prefetch.capacity &&
+         candidate.prefetch.opcode_width == prefetch.opcode_width &&
+         candidate.prefetch.countdown == prefetch.countdown &&
+         candidate.prefetch.duty == prefetch.duty &&
+         candidate.prefetch.thumb == prefetch.thumb &&
+         candidate.last_access == bus.last_access &&
+         candidate.parallel_internal_cpu_cycle_limit == bus.parallel_internal_cpu_cycle_limit &&
+         candidate.bios_latch == bus.memory.latch.bios;
+}
+
 void Core::SkipBootScreen() {
   cpu.SwitchMode(arm::MODE_SYS);
   cpu.state.bank[arm::BANK_SVC][arm::BANK_R13] = 0x03007FE0;
@@ -139,13 +321,9 @@ auto Core::SearchSoundMainRAM() -> u32 {
        */
       address = read<u32>(rom.data(), address + 0x74);
       if(address & 1) {
-        address &= ~1;
-        address += sizeof(u16) * 2;
-      } else {
-        address &= ~3;
-        address += sizeof(u32) * 2;
+        return address & ~1;
       }
-      return address;
+      return address & ~3;
     }
   }
 
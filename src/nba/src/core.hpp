@@ -5,10 +5,12 @@
  * Refer to the included LICENSE file.
  */
 
+#include <array>
 #include <nba/core.hpp>
 #include <nba/scheduler.hpp>
 
 #include "arm/arm7tdmi.hpp"
+#include "bios/hle.hpp"
 #include "bus/bus.hpp"
 #include "hw/apu/apu.hpp"
 #include "hw/ppu/ppu.hpp"
@@ -32,6 +34,8 @@ struct Core final : CoreBase {
   void CopyState(SaveState& state) override;
   void SetKeyStatus(Key key, bool pressed) override;
   void Run(int cycles) override;
+  auto AddPCHook(u32 address, PCHook hook) -> int override;
+  void RemovePCHook(int handle) override;
 
   auto GetROM() -> ROM& override;
   auto GetPRAM() -> u8* override;
@@ -47,9 +51,59 @@ struct Core final : CoreBase {
 
 private:
   void SkipBootScreen();
+  void DispatchPCHooks();
   auto SearchSoundMainRAM() -> u32;
+  void ResetIdleLoopDetection();
+  void DetectIdleLoop(u64 limit);
+  bool IsSameIdleLoopState() const;
+
+  struct PCHookEntry {
+    int handle;
+    u32 address;
+    PCHook hook;
+  };
+
+  std::vector<PCHookEntry> pc_hooks;
+  int next_pc_hook_handle = 0;
+
+  // Hooks which are installed by the core itself and recreated on every reset.
+  int hle_audio_hook = -1;
+  int hle_bios_hook = -1;
+  bool bios_attached = false;
+  bool skip_idle_loops;
+
+  // Maximum distance of a backward branch to be considered for idle loop detection.
+  static constexpr u32 kIdleLoopMaxSize = 64;
+
+  // Number of iterations that may end in a different CPU state, before a loop is rejected.
+  static constexpr int kIdleLoopMaxMismatches = 4;
+
+  // Rejected loops are observed again after a frame, because a loop may count first and only poll later.
+  static constexpr u64 kIdleLoopRetryCycles = kCyclesPerFrame;
+
+  // Caches per loop address (the value of r15 after the backward branch) whether the loop was rejected.
+  struct IdleLoop {
+    u32 address = 0xFFFFFFFF;
+    int mismatches = 0;
+    bool rejected = false;
+    u64 timestamp_retry = 0;
+  };
+
+  std::array<IdleLoop, 256> idle_loops;
+
+  // State at the start of the loop iteration which currently is being observed.
+  struct IdleLoopCandidate {
+    bool active = false;
+    u32 address;
+    u64 timestamp;
+    u64 timestamp_target;
+    arm::RegisterFile regs;
+    struct Bus::Prefetch prefetch;
+    int last_access;
+    int parallel_internal_cpu_cycle_limit;
+    u32 bios_latch;
+  } idle_loop_candidate;
 
-  u32 hle_audio_hook;
   std::shared_ptr<Config> config;
 
   Scheduler scheduler;
@@ -62,6 +116,7 @@ private:
   Timer timer;
   KeyPad keypad;
   Bus bus;
+  HLEBIOS hle_bios;
 };
 
 } // namespace nba::core
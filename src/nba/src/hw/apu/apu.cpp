@@ -26,8 +26,8 @@ APU::APU(
     , dma(dma)
     , mp2k(bus)
     , config(config) {
-  scheduler.Register(Scheduler::EventClass::APU_mixer, this, &APU::StepMixer);
-  scheduler.Register(Scheduler::EventClass::APU_sequencer, this, &APU::StepSequencer);
+  scheduler.Register<&APU::StepMixer>(Scheduler::EventClass::APU_mixer, this);
+  scheduler.Register<&APU::StepSequencer>(Scheduler::EventClass::APU_sequencer, this);
 }
 
 APU::~APU() {
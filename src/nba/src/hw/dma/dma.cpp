@@ -5,7 +5,10 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
+#include <cstring>
 #include <nba/common/compiler.hpp>
+#include <nba/common/punning.hpp>
 
 #include "bus/bus.hpp"
 #include "bus/io.hpp"
@@ -72,7 +75,7 @@ DMA::DMA(Bus& bus, IRQ& irq, Scheduler& scheduler)
     : bus(bus)
     , irq(irq)
     , scheduler(scheduler) {
-  scheduler.Register(Scheduler::EventClass::DMA_activated, this, &DMA::OnActivated);
+  scheduler.Register<&DMA::OnActivated>(Scheduler::EventClass::DMA_activated, this);
 
   Reset();
 }
@@ -190,6 +193,10 @@ void DMA::RunChannel() {
       return;
     }
 
+    if(RunBurst(channel, did_access_rom) != 0) {
+      continue;
+    }
+
     auto src_addr = channel.latch.src_addr;
     auto dst_addr = channel.latch.dst_addr;
 
@@ -267,6 +274,134 @@ void DMA::RunChannel() {
   SelectNextDMA();
 }
 
+auto DMA::RunBurst(Channel& channel, bool did_access_rom) -> u32 {
+  /* Accesses to EWRAM, IWRAM and ROM data have no side effects, so (half)words can be copied
+   * in one go, as long as no scheduler event could observe the transfer in progress.
+   * Anything else is transferred (half)word by (half)word by RunChannel().
+   */
+  if(channel.is_fifo_dma ||
+     (channel.src_cntl != Channel::Increment && channel.src_cntl != Channel::Fixed) ||
+     (channel.dst_cntl != Channel::Increment && channel.dst_cntl != Channel::Reload)) {
+    return 0;
+  }
+
+  const bool word = channel.size == Channel::Word;
+  const u32 unit = word ? sizeof(u32) : sizeof(u16);
+  const u32 src_addr = channel.latch.src_addr;
+  const u32 dst_addr = channel.latch.dst_addr;
+  const bool src_fixed = channel.src_cntl == Channel::Fixed;
+
+  auto& dst_page = bus.memory_pages[dst_addr >> 24];
+
+  if(dst_page.data == nullptr) {
+    return 0;
+  }
+
+  const u32 dst_offset = dst_addr & dst_page.mask;
+  const int write_cycles = word ? dst_page.cycles32 : dst_page.cycles16;
+  int read_cycles;
+
+  // Do not wrap around at the end of the memory region.
+  u32 length = std::min(channel.latch.length, (dst_page.mask + 1 - dst_offset) / unit);
+
+  auto& src_page = bus.memory_pages[src_addr >> 24];
+  const int src_area = GetUnaliasedMemoryArea(src_addr >> 24);
+
+  if(src_page.data != nullptr) {
+    const u32 src_offset = src_addr & src_page.mask;
+
+    read_cycles = word ? src_page.cycles32 : src_page.cycles16;
+
+    if(!src_fixed) {
+      length = std::min(length, (src_page.mask + 1 - src_offset) / unit);
+
+      // Copying forward into an overlapping destination repeats the source data, which a single copy would not.
+      if(src_page.data == dst_page.data && dst_offset > src_offset) {
+        length = std::min(length, (dst_offset - src_offset) / unit);
+      }
+    }
+  } else if(src_area == 0x08 && did_access_rom && !src_fixed && !bus.prefetch.active) {
+    // A non-sequential access is made at each 128 KiB boundary.
+    if((src_addr & 0x1'FFFF) == 0) {
+      return 0;
+    }
+
+    length = std::min(length, (0x2'0000 - (src_addr & 0x1'FFFF)) / unit);
+    read_cycles = word ? bus.wait32[Bus::Sequential][src_addr >> 24] : bus.wait16[Bus::Sequential][src_addr >> 24];
+  } else {
+    return 0;
+  }
+
+  // Scheduler events are dispatched once the timestamp reaches them, so the last cycle of the burst must be before the next event.
+  const u64 timestamp_now = scheduler.GetTimestampNow();
+  const u64 timestamp_target = scheduler.GetTimestampTarget();
+
+  if(timestamp_target <= timestamp_now) {
+    return 0;
+  }
+
+  length = (u32)std::min<u64>(length, (timestamp_target - timestamp_now - 1) / (read_cycles + write_cycles));
+
+  if(length == 0) {
+    return 0;
+  }
+
+  u8* dst = dst_page.data + dst_offset;
+  u8 const* src;
+
+  if(src_page.data != nullptr) {
+    src = src_page.data + (src_addr & src_page.mask);
+  } else {
+    src = bus.memory.rom.GetSequentialData(src_addr, length * unit);
+
+    if(src == nullptr) {
+      return 0;
+    }
+  }
+
+  const u32 size = length * unit;
+
+  if(src_fixed) {
+    if(word) {
+      const u32 value = read<u32>(src, 0);
+
+      channel.latch.bus = value;
+
+      for(u32 offset = 0; offset < size; offset += sizeof(u32)) {
+        write<u32>(dst, offset, value);
+      }
+    } else {
+      const u16 value = read<u16>(src, 0);
+
+      channel.latch.bus = (value << 16) | value;
+
+      for(u32 offset = 0; offset < size; offset += sizeof(u16)) {
+        write<u16>(dst, offset, value);
+      }
+    }
+  } else {
+    if(word) {
+      channel.latch.bus = read<u32>(src, size - sizeof(u32));
+    } else {
+      const u16 value = read<u16>(src, size - sizeof(u16));
+
+      channel.latch.bus = (value << 16) | value;
+    }
+
+    std::memmove(dst, src, size);
+
+    channel.latch.src_addr += size;
+  }
+
+  latch = channel.latch.bus;
+  channel.latch.dst_addr += size;
+  channel.latch.length -= length;
+
+  bus.StepBurst(read_cycles, write_cycles, (int)length);
+
+  return length;
+}
+
 auto DMA::Read(int chan_id, int offset) -> u8 {
   auto const& channel = channels[chan_id];
 
@@ -334,6 +469,20 @@ void DMA::Write(int chan_id, int offset, u8 value) {
   }
 }
 
+auto DMA::ReadHalf(int chan_id, int offset) -> u16 {
+  return Read(chan_id, offset) | (Read(chan_id, offset + 1) << 8);
+}
+
+void DMA::WriteHalf(int chan_id, int offset, u16 value) {
+  Write(chan_id, offset + 0, (u8)value);
+  Write(chan_id, offset + 1, (u8)(value >> 8));
+}
+
+void DMA::WriteWord(int chan_id, int offset, u32 value) {
+  WriteHalf(chan_id, offset + 0, (u16)value);
+  WriteHalf(chan_id, offset + 2, (u16)(value >> 16));
+}
+
 void DMA::OnChannelWritten(Channel& channel, bool enable_old) {
   bool enable_new = channel.enable;
 
@@ -36,6 +36,9 @@ struct DMA {
   auto Run() -> int;
   auto Read (int chan_id, int offset) -> u8;
   void Write(int chan_id, int offset, u8 value);
+  auto ReadHalf (int chan_id, int offset) -> u16;
+  void WriteHalf(int chan_id, int offset, u16 value);
+  void WriteWord(int chan_id, int offset, u32 value);
   bool IsRunning() { return runnable_set.any(); }
   auto GetOpenBusValue() -> u32 { return latch; }
 
@@ -113,6 +116,7 @@ private:
   void AddChannelToDMASet(Channel& channel);
   void RemoveChannelFromDMASets(Channel& channel);
   void RunChannel();
+  auto RunBurst(Channel& channel, bool did_access_rom) -> u32;
 
   Bus& bus;
   IRQ& irq;
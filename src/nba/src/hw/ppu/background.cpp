@@ -50,6 +50,12 @@ void PPU::DrawBackground() {
     return;
   }
 
+  DrawBackgroundCycles(cycles);
+
+  bg.timestamp_last_sync = timestamp_now;
+}
+
+void PPU::DrawBackgroundCycles(int cycles) {
   const int mode = mmio.dispcnt.mode;
 
   switch(mode) {
@@ -62,8 +68,6 @@ void PPU::DrawBackground() {
     case 6: 
     case 7: DrawBackgroundImpl<7>(cycles); break;
   }
-
-  bg.timestamp_last_sync = timestamp_now;
 }
 
 template<int mode> void PPU::DrawBackgroundImpl(int cycles) {
@@ -119,54 +123,58 @@ template<int mode> void PPU::DrawBackgroundImpl(int cycles) {
 
     // @todo: research mosaic timing and narrow down the BG X/Y timing more precisely.
     if(cycle == 1232U) {
-      auto& mosaic = mmio.mosaic;
+      EndBackgroundLine(mode, latched_dispcnt_and_current_dispcnt);
+    }
 
-      if(mmio.vcount < 159) {
-        if(++mosaic.bg._counter_y == mosaic.bg.size_y) {
-          mosaic.bg._counter_y = 0;
-        } else {
-          mosaic.bg._counter_y &= 15;
-        }
-      } else {
-        mosaic.bg._counter_y = 0;
-      }
+    if(++bg.cycle == 1232U) {
+      break;
+    }
+  }
+}
 
-      auto& bgx = mmio.bgx;
-      auto& bgy = mmio.bgy;
-      auto& bgpb = mmio.bgpb;
-      auto& bgpd = mmio.bgpd;
-
-      const auto AdvanceBGXY = [&](int id) {
-        auto bg_id = 2 + id;
-
-        /* Do not update internal X/Y unless the latched BG enable bit is set.
-         * This behavior was confirmed on real hardware.
-         */
-        if(latched_dispcnt_and_current_dispcnt & (256U << bg_id)) {
-          if(mmio.bgcnt[bg_id].mosaic_enable) {
-            if(mosaic.bg._counter_y == 0) {
-              bgx[id]._current += mosaic.bg.size_y * bgpb[id];
-              bgy[id]._current += mosaic.bg.size_y * bgpd[id];
-            }
-          } else {
-            bgx[id]._current += bgpb[id];
-            bgy[id]._current += bgpd[id];
-          }
-        }
-      };
+void PPU::EndBackgroundLine(int mode, u16 latched_dispcnt_and_current_dispcnt) {
+  auto& mosaic = mmio.mosaic;
 
-      if constexpr(mode >= 1 && mode <= 5) {
-        AdvanceBGXY(0);
-      }
+  if(mmio.vcount < 159) {
+    if(++mosaic.bg._counter_y == mosaic.bg.size_y) {
+      mosaic.bg._counter_y = 0;
+    } else {
+      mosaic.bg._counter_y &= 15;
+    }
+  } else {
+    mosaic.bg._counter_y = 0;
+  }
 
-      if constexpr(mode == 2) {
-        AdvanceBGXY(1);
+  auto& bgx = mmio.bgx;
+  auto& bgy = mmio.bgy;
+  auto& bgpb = mmio.bgpb;
+  auto& bgpd = mmio.bgpd;
+
+  const auto AdvanceBGXY = [&](int id) {
+    auto bg_id = 2 + id;
+
+    /* Do not update internal X/Y unless the latched BG enable bit is set.
+     * This behavior was confirmed on real hardware.
+     */
+    if(latched_dispcnt_and_current_dispcnt & (256U << bg_id)) {
+      if(mmio.bgcnt[bg_id].mosaic_enable) {
+        if(mosaic.bg._counter_y == 0) {
+          bgx[id]._current += mosaic.bg.size_y * bgpb[id];
+          bgy[id]._current += mosaic.bg.size_y * bgpd[id];
+        }
+      } else {
+        bgx[id]._current += bgpb[id];
+        bgy[id]._current += bgpd[id];
       }
     }
+  };
 
-    if(++bg.cycle == 1232U) {
-      break;
-    }
+  if(mode >= 1 && mode <= 5) {
+    AdvanceBGXY(0);
+  }
+
+  if(mode == 2) {
+    AdvanceBGXY(1);
   }
 }
 
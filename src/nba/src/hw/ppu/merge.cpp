@@ -5,20 +5,12 @@
  * Refer to the included LICENSE file.
  */
 
-#include <algorithm>
+#include <cstring>
 
 #include "ppu.hpp"
 
 namespace nba::core {
 
-static u32 RGB555(u16 rgb555) {
-  const uint r = (rgb555 >>  0) & 31U;
-  const uint g = (rgb555 >>  5) & 31U;
-  const uint b = (rgb555 >> 10) & 31U;
-
-  return 0xFF000000 | (r << 3 | r >> 2) << 16 | (g << 3 | g >> 2) << 8 | (b << 3 | b >> 2);
-}
-
 void PPU::InitMerge() {
   const u64 timestamp_now = scheduler.GetTimestampNow();
   
@@ -100,21 +92,13 @@ void PPU::DrawMergeImpl(int cycles) {
 
     const uint x = (uint)cycle >> 2;
 
-    // @todo: optimize this, this is baaad
-    if(have_windows) {
-      if(enable_win0 && window.buffer[x][0]) {
-        win_layer_enable = mmio.winin.enable[0];
-      } else if(enable_win1 && window.buffer[x][1]) {
-        win_layer_enable = mmio.winin.enable[1];
-      } else if(enable_objwin && sprite.buffer_rd[x].window) {
-        win_layer_enable = mmio.winout.enable[1];
-      } else {
-        win_layer_enable = mmio.winout.enable[0];
-      }
-    }
-
     const int phase = cycle & 3;
 
+    // The window layer selection is only needed in the phases that select the layers and apply the color effects.
+    if(have_windows && (phase & 1) == 0) {
+      win_layer_enable = GetWindowLayerEnable(x, enable_win0, enable_win1, enable_objwin);
+    }
+
     if(phase == 0) {
       merge.forced_blank = ForcedBlank();
 
@@ -195,7 +179,7 @@ void PPU::DrawMergeImpl(int cycles) {
             colors[1] = FetchPRAM(merge.cycle, colors[1] << 1);
           }
 
-          colors[0] = Blend(colors[0], colors[1], mmio.eva, mmio.evb);
+          colors[0] = BlendRGB555(colors[0], colors[1], mmio.eva, mmio.evb);
         } else if(!have_windows || win_layer_enable[LAYER_SFX]) {
           const bool have_dst = mmio.bldcnt.targets[0][layers[0]];
 
@@ -207,19 +191,19 @@ void PPU::DrawMergeImpl(int cycles) {
                   colors[1] = FetchPRAM(merge.cycle, colors[1] << 1);
                 }
 
-                colors[0] = Blend(colors[0], colors[1], mmio.eva, mmio.evb);
+                colors[0] = BlendRGB555(colors[0], colors[1], mmio.eva, mmio.evb);
               }
               break;
             }
             case BlendControl::SFX_BRIGHTEN: {
               if(have_dst) {
-                colors[0] = Brighten(colors[0], mmio.evy);
+                colors[0] = BrightenRGB555(colors[0], mmio.evy);
               }
               break;
             }
             case BlendControl::SFX_DARKEN: {
               if(have_dst) {
-                colors[0] = Darken(colors[0], mmio.evy);
+                colors[0] = DarkenRGB555(colors[0], mmio.evy);
               }
               break;
             }
@@ -227,7 +211,9 @@ void PPU::DrawMergeImpl(int cycles) {
         }
       }
 
-      if(x & 1) {
+      if(skip_frame) {
+        // Only the PRAM fetches are needed on skipped frames.
+      } else if(x & 1) {
         u16 color_l = merge.color_l;
         u16 color_r = colors[0];
 
@@ -243,8 +229,8 @@ void PPU::DrawMergeImpl(int cycles) {
 
         u32* out = &output[frame][mmio.vcount * 240 + (x & ~1)];
 
-        out[0] = RGB555(color_l);
-        out[1] = RGB555(color_r);
+        out[0] = RGB555ToARGB8888(color_l);
+        out[1] = RGB555ToARGB8888(color_r);
       } else {
         merge.color_l = colors[0];
       }
@@ -259,60 +245,21 @@ void PPU::DrawMergeImpl(int cycles) {
     }
 
     if(++merge.cycle == 1006U) {
+      if(!skip_frame) {
+        EndMergeLine();
+      }
       break;
     }
   }
 }
 
-auto PPU::Blend(u16 color_a, u16 color_b, int eva, int evb) -> u16 {
-  const int r_a =  (color_a >>  0) & 31;
-  const int g_a = ((color_a >>  4) & 62) | (color_a >> 15);
-  const int b_a =  (color_a >> 10) & 31;
-
-  const int r_b =  (color_b >>  0) & 31;
-  const int g_b = ((color_b >>  4) & 62) | (color_b >> 15);
-  const int b_b =  (color_b >> 10) & 31;
-
-  eva = std::min<int>(16, eva);
-  evb = std::min<int>(16, evb);
-
-  const int r = std::min<u8>((r_a * eva + r_b * evb + 8) >> 4, 31);
-  const int g = std::min<u8>((g_a * eva + g_b * evb + 8) >> 4, 63) >> 1;
-  const int b = std::min<u8>((b_a * eva + b_b * evb + 8) >> 4, 31);
-
-  return (u16)((b << 10) | (g << 5) | r);
-}
-
-auto PPU::Brighten(u16 color, int evy) -> u16 {
-  evy = std::min<int>(16, evy);
-
-  int r =  (color >>  0) & 31;
-  int g = ((color >>  4) & 62) | (color >> 15);
-  int b =  (color >> 10) & 31;
+void PPU::EndMergeLine() {
+  const uint offset = mmio.vcount * 240;
 
-  r += ((31 - r) * evy + 8) >> 4;
-  g += ((63 - g) * evy + 8) >> 4;
-  b += ((31 - b) * evy + 8) >> 4;
-
-  g >>= 1;
-  
-  return (u16)((b << 10) | (g << 5) | r);
-}
-
-auto PPU::Darken(u16 color, int evy) -> u16 {
-  evy = std::min<int>(16, evy);
-
-  int r =  (color >>  0) & 31;
-  int g = ((color >>  4) & 62) | (color >> 15);
-  int b =  (color >> 10) & 31;
-
-  r -= (r * evy + 7) >> 4;
-  g -= (g * evy + 7) >> 4;
-  b -= (b * evy + 7) >> 4;
-
-  g >>= 1;
-
-  return (u16)((b << 10) | (g << 5) | r);
+  // The previous frame still is in the other output buffer.
+  if(!frame_changed && std::memcmp(&output[frame][offset], &output[frame ^ 1][offset], sizeof(u32) * 240) != 0) {
+    frame_changed = true;
+  }
 }
 
 } // namespace nba::core
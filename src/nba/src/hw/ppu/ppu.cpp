@@ -20,21 +20,23 @@ PPU::PPU(
     , irq(irq)
     , dma(dma)
     , config(config) {
-  scheduler.Register(Scheduler::EventClass::PPU_hdraw_vdraw, this, &PPU::BeginHDrawVDraw);
-  scheduler.Register(Scheduler::EventClass::PPU_hblank_vdraw, this, &PPU::BeginHBlankVDraw);
-  scheduler.Register(Scheduler::EventClass::PPU_hdraw_vblank, this, &PPU::BeginHDrawVBlank);
-  scheduler.Register(Scheduler::EventClass::PPU_hblank_vblank, this, &PPU::BeginHBlankVBlank);
-  scheduler.Register(Scheduler::EventClass::PPU_begin_sprite_fetch, this, &PPU::BeginSpriteDrawing);
-
-  scheduler.Register(Scheduler::EventClass::PPU_update_vcount_flag, this, &PPU::UpdateVerticalCounterFlag);
-  scheduler.Register(Scheduler::EventClass::PPU_video_dma, this, &PPU::RequestVideoDMA);
-  scheduler.Register(Scheduler::EventClass::PPU_latch_dispcnt, this, &PPU::LatchDISPCNT);
-  scheduler.Register(Scheduler::EventClass::PPU_hblank_irq, this, &PPU::RequestHblankIRQ);
-  scheduler.Register(Scheduler::EventClass::PPU_vblank_irq, this, &PPU::RequestVblankIRQ);
-  scheduler.Register(Scheduler::EventClass::PPU_vcount_irq, this, &PPU::RequestVcountIRQ);
+  scheduler.Register<&PPU::BeginHDrawVDraw>(Scheduler::EventClass::PPU_hdraw_vdraw, this);
+  scheduler.Register<&PPU::BeginHBlankVDraw>(Scheduler::EventClass::PPU_hblank_vdraw, this);
+  scheduler.Register<&PPU::BeginHDrawVBlank>(Scheduler::EventClass::PPU_hdraw_vblank, this);
+  scheduler.Register<&PPU::BeginHBlankVBlank>(Scheduler::EventClass::PPU_hblank_vblank, this);
+  scheduler.Register<&PPU::BeginSpriteDrawing>(Scheduler::EventClass::PPU_begin_sprite_fetch, this);
+
+  scheduler.Register<&PPU::UpdateVerticalCounterFlag>(Scheduler::EventClass::PPU_update_vcount_flag, this);
+  scheduler.Register<&PPU::RequestVideoDMA>(Scheduler::EventClass::PPU_video_dma, this);
+  scheduler.Register<&PPU::LatchDISPCNT>(Scheduler::EventClass::PPU_latch_dispcnt, this);
+  scheduler.Register<&PPU::RequestHblankIRQ>(Scheduler::EventClass::PPU_hblank_irq, this);
+  scheduler.Register<&PPU::RequestVblankIRQ>(Scheduler::EventClass::PPU_vblank_irq, this);
+  scheduler.Register<&PPU::RequestVcountIRQ>(Scheduler::EventClass::PPU_vcount_irq, this);
 
   mmio.dispcnt.ppu = this;
   mmio.dispstat.ppu = this;
+  mmio.winh[0].ppu = this;
+  mmio.winh[1].ppu = this;
   Reset();
 }
 
@@ -42,6 +44,7 @@ void PPU::Reset() {
   std::memset(pram, 0, 0x00400);
   std::memset(oam,  0, 0x00400);
   std::memset(vram, 0, 0x18000);
+  tile_cache.Invalidate(0U, 0x18000U);
 
   vram_bg_latch = 0U;
 
@@ -88,29 +91,55 @@ void PPU::Reset() {
   mmio.dispstat.hblank_flag = true;
   scheduler.Add(226, Scheduler::EventClass::PPU_hdraw_vblank);
 
-  // To keep the state machine simple, we run sprite engine
-  // from a separate event loop.
-  scheduler.Add(266, Scheduler::EventClass::PPU_begin_sprite_fetch);
-
   // @todo: initialize window with the appropriate timing.
   bg = {};
   sprite = {};
   sprite.buffer_rd = sprite.buffer[0];
   sprite.buffer_wr = sprite.buffer[1];
+  sprite.dirty_objects[0] = ~0ULL;
+  sprite.dirty_objects[1] = ~0ULL;
   window = {};
   merge = {};
 
   frame = 0;
+  frame_count = 0U;
+  frame_changed = true;
+  skip_frame = false;
+  skip_next_frame = false;
   dma3_video_transfer_running = false;
+
+  scanline_renderer = config->scanline_renderer;
+
+  /* To keep the state machine simple, we run sprite engine from a separate event loop.
+   * The scanline renderer draws the sprites of the next scanline at the start of H-blank instead.
+   */
+  if(!scanline_renderer) {
+    scheduler.Add(266, Scheduler::EventClass::PPU_begin_sprite_fetch);
+  }
+
+  StopRenderThread();
+
+  if(scanline_renderer && config->threaded_renderer) {
+    StartRenderThread();
+  }
+}
+
+PPU::~PPU() {
+  StopRenderThread();
 }
 
 void PPU::BeginHDrawVDraw() {
   auto& dispstat = mmio.dispstat;
   auto& vcount = mmio.vcount;
 
-  DrawBackground();
-  DrawWindow();
-  DrawMerge();
+  if(scanline_renderer) {
+    EndBackgroundLine(mmio.dispcnt.mode, mmio.dispcnt_latch[0] & mmio.dispcnt.hword);
+    EndWindow();
+  } else {
+    FinishBackground();
+    EndWindow();
+    FinishMerge();
+  }
 
   scheduler.Add(1, Scheduler::EventClass::PPU_update_vcount_flag);
   scheduler.Add(40, Scheduler::EventClass::PPU_latch_dispcnt);
@@ -139,6 +168,10 @@ void PPU::BeginHDrawVDraw() {
 }
 
 void PPU::BeginHBlankVDraw() {
+  if(scanline_renderer) {
+    RenderScanline();
+  }
+
   mmio.dispstat.hblank_flag = 1;
 
   RequestHblankDMA();
@@ -154,7 +187,7 @@ void PPU::BeginHDrawVBlank() {
   auto& vcount = mmio.vcount;
   auto& dispstat = mmio.dispstat;
 
-  DrawWindow();
+  EndWindow();
 
   scheduler.Add(1, Scheduler::EventClass::PPU_update_vcount_flag);
 
@@ -177,8 +210,23 @@ void PPU::BeginHDrawVBlank() {
     scheduler.Add(1007, Scheduler::EventClass::PPU_hblank_vdraw);
     vcount = 0;
 
-    config->video_dev->Draw(output[frame]);
-    frame ^= 1;
+    if(!skip_frame) {
+      if(render_thread.ppu) {
+        WaitForRenderThread();
+      }
+
+      // With the threaded renderer the frame was drawn by the render thread's PPU.
+      PPU& ppu = render_thread.ppu ? *render_thread.ppu : *this;
+
+      const VideoDevice::FrameInfo frame_info{frame_count, scheduler.GetTimestampNow(), !ppu.frame_changed};
+
+      config->video_dev->Draw(ppu.output[frame], frame_info);
+      ppu.frame_changed = false;
+      frame ^= 1;
+    }
+
+    frame_count++;
+    skip_frame = skip_next_frame;
 
     InitBackground();
     InitMerge();
@@ -187,6 +235,9 @@ void PPU::BeginHDrawVBlank() {
     
     if(++vcount == 227) {
       dispstat.vblank_flag = 0;
+
+      // The sprites of the first scanline of the next frame are drawn during this scanline.
+      skip_next_frame = IsFrameSkipped(frame_count + 1U);
     }
   }
 
@@ -200,6 +251,19 @@ void PPU::BeginHBlankVBlank() {
 
   dispstat.hblank_flag = 1;
 
+  if(scanline_renderer && mmio.vcount == 227) {
+    if(skip_next_frame) {
+      InitSprite();
+      EndSpriteLine();
+    } else if(render_thread.ppu) {
+      SubmitScanline(false, true);
+    } else {
+      InitSprite();
+      RenderScanlineSprites();
+      std::swap(sprite.buffer_rd, sprite.buffer_wr);
+    }
+  }
+
   if(mmio.dispstat.hblank_irq_enable) {
     scheduler.Add(1, Scheduler::EventClass::PPU_hblank_irq);
   }
@@ -211,7 +275,7 @@ void PPU::BeginSpriteDrawing() {
   const uint vcount = mmio.vcount;
 
   if(vcount < 160U) {
-    DrawSprite();
+    FinishSprite();
   }
 
   if(vcount == 227U || vcount < 160U) {
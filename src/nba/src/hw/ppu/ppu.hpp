@@ -7,13 +7,20 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <nba/common/color.hpp>
 #include <nba/common/compiler.hpp>
 #include <nba/common/punning.hpp>
 #include <nba/config.hpp>
 #include <nba/integer.hpp>
 #include <nba/save_state.hpp>
 #include <nba/scheduler.hpp>
+#include <nba/tile_cache.hpp>
+#include <thread>
 #include <type_traits>
 
 #include "hw/ppu/registers.hpp"
@@ -30,6 +37,8 @@ struct PPU {
     std::shared_ptr<Config> config
   );
 
+ ~PPU();
+
   void Reset();
 
   void LoadState(SaveState const& state);
@@ -104,6 +113,9 @@ struct PPU {
     } else {
       write<T>(vram, address, value);
     }
+
+    tile_cache.Invalidate(address);
+    MarkVRAMDirty(address);
   }
 
   template<typename T>
@@ -118,6 +130,8 @@ struct PPU {
       }
 
       write<T>(vram, address, value);
+      tile_cache.Invalidate(address);
+      MarkVRAMDirty(address);
     }
   }
 
@@ -129,7 +143,16 @@ struct PPU {
   template<typename T>
   void ALWAYS_INLINE WriteOAM(u32 address, T value) noexcept {
     if constexpr (!std::is_same_v<T, u8>) {
-      write<T>(oam, address & 0x3FF, value);
+      address &= 0x3FF;
+
+      write<T>(oam, address, value);
+
+      // Attributes #0 and #1 decide which scanlines the OBJ is on.
+      if((address & 4U) == 0U) {
+        const uint index = address >> 3;
+
+        sprite.dirty_objects[index >> 6] |= 1ULL << (index & 63U);
+      }
     }
   }
 
@@ -149,16 +172,52 @@ struct PPU {
     return scheduler.GetTimestampNow() == sprite.timestamp_oam_access + 1U;
   }
 
+  // Catches up all units, which is required before any of the PPU registers is written.
   void Sync() {
-    // @todo: only update the window when it is necessary or else
-    // we will have a major performance caveat due to the window being updated 
-    // during V-blank and games typically updating graphics during V-blank.
+    if(scanline_renderer) {
+      return;
+    }
+
     DrawBackground();
     DrawSprite();
     DrawWindow();
     DrawMerge();
   }
 
+  /* Memory accesses only need to catch up the units that access the same memory.
+   * The other units will see the same memory contents whenever they catch up.
+   */
+  void SyncPRAM() {
+    if(scanline_renderer) {
+      return;
+    }
+
+    // The merge unit consumes the output of the BG and window units in the same scanline.
+    if(merge.cycle < 1006U) {
+      DrawBackground();
+      DrawWindow();
+      DrawMerge();
+    }
+  }
+
+  void SyncVRAM_BG() {
+    if(!scanline_renderer) {
+      DrawBackground();
+    }
+  }
+
+  void SyncVRAM_OBJ() {
+    if(!scanline_renderer) {
+      DrawSprite();
+    }
+  }
+
+  void SyncOAM() {
+    if(!scanline_renderer) {
+      DrawSprite();
+    }
+  }
+
   struct MMIO {
     DisplayControl dispcnt;
     DisplayStatus dispstat;
@@ -195,6 +254,12 @@ struct PPU {
 
 private:
   friend struct DisplayStatus;
+  friend struct WindowRange;
+
+  struct RenderOnly {};
+
+  // Creates a PPU that only runs the scanline renderer, for the render thread.
+  PPU(PPU& parent, RenderOnly);
 
   enum ObjAttribute {
     OBJ_IS_ALPHA  = 1,
@@ -296,7 +361,9 @@ private:
 
   void InitBackground();
   void DrawBackground();
+  void DrawBackgroundCycles(int cycles);
   template<int mode> void DrawBackgroundImpl(int cycles);
+  void EndBackgroundLine(int mode, u16 latched_dispcnt_and_current_dispcnt);
 
   struct Sprite {
     u64 timestamp_init = 0;
@@ -361,6 +428,11 @@ private:
     Pixel* buffer_wr;
 
     uint latch_cycle_limit;
+
+    // The OBJs that intersect each scanline and the range of scanlines of each OBJ.
+    u64 line_objects[160][2];
+    u8  object_lines[128][2];
+    u64 dirty_objects[2];
   } sprite;
 
   void InitSprite();
@@ -368,19 +440,30 @@ private:
   void DrawSpriteImpl(int cycles);
   void DrawSpriteFetchOAM(uint cycle);
   void DrawSpriteFetchVRAM(uint cycle);
+  void EndSpriteLine();
+  void UpdateSpriteLines();
+
+  bool ALWAYS_INLINE IsSpriteOnLine(uint index) const {
+    return (sprite.line_objects[sprite.vcount][index >> 6] >> (index & 63U)) & 1U;
+  }
 
   struct Window {
-    u64 timestamp_last_sync;
-    uint cycle;
+    u64 timestamp_init;
+    uint x_begin;
+    bool dirty;
 
     bool v_flag[2] {false, false};
     bool h_flag[2] {false, false};
 
-    bool buffer[240][2];
+    // One bit per pixel, which is set if the pixel is inside the window.
+    u64 mask[2][4];
   } window;
 
   void InitWindow();
   void DrawWindow();
+  void AdvanceWindow(uint x);
+  void EndWindow();
+  void OnWindowRangeWrite();
 
   struct Merge {
     u64 timestamp_init = 0;
@@ -399,15 +482,119 @@ private:
   void InitMerge();
   void DrawMerge();
   void DrawMergeImpl(int cycles);
+  void EndMergeLine();
+
+  /* The threaded renderer runs the scanline renderer on a render thread, which has its own PPU.
+   * At the start of H-blank the emulation thread records the state that the scanline renderer reads
+   * in a job. Jobs are passed to the render thread through a ring buffer with a single producer and consumer.
+   * The 1 KiB blocks of VRAM that a job carries are copied into a second ring buffer of VRAM pages,
+   * so that only the blocks which are in flight take up memory.
+   */
+  struct RenderThread {
+    static constexpr int k_job_count = 16;
+    static constexpr int k_vram_page_count = 128;
+
+    struct Job {
+      bool draw_scanline;
+      bool draw_sprites;
+      int frame;
+
+      MMIO mmio;
+      s32 bg_x[2];
+      s32 bg_y[2];
+      Window window;
+
+      uint sprite_vcount;
+      int sprite_mosaic_y;
+      uint sprite_latch_cycle_limit;
+      u64 dirty_objects[2];
+
+      u8 pram[0x00400];
+      u8 oam [0x00400];
+
+      /* Only the 1 KiB blocks of VRAM that were written since the previous job are copied.
+       * The blocks are stored in ascending order in the VRAM pages starting at vram_page_index, which wrap around.
+       */
+      u64 dirty_vram[2];
+      u64 vram_page_index;
+      uint vram_page_count;
+    };
+
+    std::unique_ptr<PPU> ppu;
+    std::unique_ptr<Job[]> jobs;
+    std::unique_ptr<u8[]> vram_pages;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<u64> rd_index = 0U;
+    std::atomic<u64> wr_index = 0U;
+    std::atomic<u64> vram_page_rd_index = 0U;
+    u64 vram_page_wr_index = 0U;
+    bool quit = false;
+
+    u64 dirty_vram[2] {~0ULL, 0xFFFFFFFFULL};
+  } render_thread;
+
+  void StartRenderThread();
+  void StopRenderThread();
+
+  /* Waits until the render thread has drawn all submitted scanlines.
+   * This must be called before a save state is created or loaded and before Reset(),
+   * because the render thread's PPU carries state from one scanline to the next.
+   */
+  void WaitForRenderThread();
+  void RunRenderThread();
+  void SubmitScanline(bool draw_scanline, bool draw_sprites);
+  void DrawScanline(RenderThread::Job const& job, u8 const* vram_pages);
+
+  void ALWAYS_INLINE MarkVRAMDirty(u32 address) noexcept {
+    render_thread.dirty_vram[address >> 16] |= 1ULL << ((address >> 10) & 63U);
+  }
+
+  // VRAM consists of 96 blocks of 1 KiB.
+  void MarkVRAMDirty() {
+    render_thread.dirty_vram[0] = ~0ULL;
+    render_thread.dirty_vram[1] = 0xFFFFFFFFULL;
+  }
   
-  static auto Blend(u16 color_a, u16 color_b, int eva, int evb) -> u16;
-  static auto Brighten(u16 color, int evy) -> u16;
-  static auto Darken(u16 color, int evy) -> u16;
+  void FinishBackground();
+  void FinishMerge();
+  void FinishSprite();
+
+  void RenderScanline();
+  void RenderScanlineBackground();
+  template<int mode> void RenderScanlineBackgroundImpl();
+  void LatchScanlineFetch(uint cycle, u32 address, uint& latch_cycle);
+  bool RenderScanlineTextBG(int id, uint& latch_cycle);
+  void RenderScanlineAffineBG(int id, uint& latch_cycle);
+  template<int mode> void RenderScanlineBitmapBG(uint& latch_cycle);
+  void RenderScanlineMerge();
+  void RenderScanlineSprites();
 
   bool ALWAYS_INLINE ForcedBlank() const {
     return (mmio.dispcnt_latch[0] | mmio.dispcnt.hword) & 0x80U;
   }
 
+  bool ALWAYS_INLINE InsideWindow(int id, uint x) const {
+    return (window.mask[id][x >> 6] >> (x & 63U)) & 1U;
+  }
+
+  auto ALWAYS_INLINE GetWindowLayerEnable(uint x, bool enable_win0, bool enable_win1, bool enable_objwin) const -> const int* {
+    if(enable_win0 && InsideWindow(0, x)) {
+      return mmio.winin.enable[0];
+    }
+
+    if(enable_win1 && InsideWindow(1, x)) {
+      return mmio.winin.enable[1];
+    }
+
+    if(enable_objwin && sprite.buffer_rd[x].window) {
+      return mmio.winout.enable[1];
+    }
+
+    return mmio.winout.enable[0];
+  }
+
   auto ALWAYS_INLINE FetchPRAM(uint cycle, uint address) -> u16 {
     merge.timestamp_pram_access = merge.timestamp_init + cycle;
     return read<u16>(pram, address);
@@ -447,6 +634,8 @@ private:
   u8 oam [0x00400];
   u8 vram[0x18000];
 
+  TileCache tile_cache{vram};
+
   u16 vram_bg_latch;
 
   Scheduler& scheduler;
@@ -456,9 +645,25 @@ private:
 
   u32 output[2][240 * 160];
   int frame;
+  u64 frame_count;
+
+  // Set once a scanline of the current frame differs from the previous frame.
+  bool frame_changed;
+
+  // Skipped frames are emulated as usual, but no pixels are drawn and they are not presented.
+  bool skip_frame;
+  bool skip_next_frame;
+
+  bool IsFrameSkipped(u64 number) const {
+    const int frame_skip = config->frame_skip;
+
+    return frame_skip > 0 && number % (u64)(frame_skip + 1) != 0U;
+  }
 
   bool dma3_video_transfer_running;
 
+  bool scanline_renderer;
+
   #include "background.inl"
 };
 
@@ -172,12 +172,26 @@ void ReferencePoint::Write(int address, u8 value) {
   written = true;
 }
 
+void ReferencePoint::WriteHalf(int address, u16 value) {
+  Write(address + 0, (u8)value);
+  Write(address + 1, (u8)(value >> 8));
+}
+
+void ReferencePoint::WriteWord(u32 value) {
+  WriteHalf(0, (u16)value);
+  WriteHalf(2, (u16)(value >> 16));
+}
+
 void WindowRange::Reset() {
   min = 0;
   max = 0;
 }
 
 void WindowRange::Write(int address, u8 value) {
+  if(ppu != nullptr) {
+    ppu->OnWindowRangeWrite();
+  }
+
   switch(address) {
     case 0:
       max = value;
@@ -296,4 +310,9 @@ void Mosaic::Write(int address, u8 value) {
   }
 }
 
+void Mosaic::WriteHalf(u16 value) {
+  Write(0, (u8)value);
+  Write(1, (u8)(value >> 8));
+}
+
 } // namespace nba::core
@@ -83,6 +83,9 @@ struct ReferencePoint {
 
   void Reset();
   void Write(int address, u8 value);
+
+  void WriteHalf(int address, u16 value);
+  void WriteWord(u32 value);
 };
   
 struct BlendControl {
@@ -112,6 +115,9 @@ struct WindowRange {
 
   auto ReadHalf() -> u16;
   void WriteHalf(u16 value);
+
+  // Only set for WINxH, which can take effect in the middle of a scanline.
+  PPU* ppu = nullptr;
 };
 
 struct WindowLayerSelect {
@@ -134,6 +140,8 @@ struct Mosaic {
   
   void Reset();
   void Write(int address, u8 value);
+
+  void WriteHalf(u16 value);
 };
 
 } // namespace nba::core
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <cstring>
+
+#include "ppu.hpp"
+
+/* The render thread draws the same scanlines from the same state as the single-threaded scanline renderer,
+ * so the frames are bit-identical. The render thread runs up to RenderThread::k_job_count jobs behind
+ * the emulation thread, which waits for it to catch up before a frame is presented and before a save state is
+ * created or loaded. The only state that the scanline renderer carries from one scanline to the next is kept
+ * by the render thread's PPU: the sprite buffers, the OBJ line tables and the last BG VRAM fetch.
+ */
+
+namespace nba::core {
+
+PPU::PPU(PPU& parent, RenderOnly)
+    : scheduler(parent.scheduler)
+    , irq(parent.irq)
+    , dma(parent.dma)
+    , config(parent.config) {
+  std::memset(pram, 0, 0x00400);
+  std::memset(oam,  0, 0x00400);
+  std::memset(vram, 0, 0x18000);
+  tile_cache.Invalidate(0U, 0x18000U);
+
+  vram_bg_latch = 0U;
+
+  bg = {};
+  sprite = {};
+  sprite.buffer_rd = sprite.buffer[0];
+  sprite.buffer_wr = sprite.buffer[1];
+  sprite.dirty_objects[0] = ~0ULL;
+  sprite.dirty_objects[1] = ~0ULL;
+  window = {};
+  merge = {};
+
+  // The first frame after a reset is presented before any scanline was drawn.
+  std::memcpy(output, parent.output, sizeof(output));
+
+  frame = 0;
+  frame_changed = true;
+  skip_frame = false;
+  skip_next_frame = false;
+  dma3_video_transfer_running = false;
+
+  scanline_renderer = true;
+}
+
+void PPU::StartRenderThread() {
+  render_thread.ppu = std::unique_ptr<PPU>{new PPU{*this, RenderOnly{}}};
+  render_thread.jobs = std::make_unique<RenderThread::Job[]>(RenderThread::k_job_count);
+  render_thread.vram_pages = std::make_unique<u8[]>(RenderThread::k_vram_page_count * 0x400);
+  render_thread.rd_index = 0U;
+  render_thread.wr_index = 0U;
+  render_thread.vram_page_rd_index = 0U;
+  render_thread.vram_page_wr_index = 0U;
+  render_thread.quit = false;
+
+  // The render thread's PPU starts out with blank VRAM, so the first job has to copy all of it.
+  MarkVRAMDirty();
+  render_thread.ppu->vram_bg_latch = vram_bg_latch;
+
+  render_thread.thread = std::thread{[this]() {
+    RunRenderThread();
+  }};
+}
+
+void PPU::StopRenderThread() {
+  if(!render_thread.thread.joinable()) {
+    return;
+  }
+
+  WaitForRenderThread();
+
+  {
+    std::lock_guard lock{render_thread.mutex};
+    render_thread.quit = true;
+  }
+  render_thread.cv.notify_all();
+  render_thread.thread.join();
+
+  render_thread.ppu.reset();
+  render_thread.jobs.reset();
+  render_thread.vram_pages.reset();
+}
+
+void PPU::WaitForRenderThread() {
+  const u64 wr_index = render_thread.wr_index.load(std::memory_order_relaxed);
+
+  if(render_thread.rd_index.load(std::memory_order_acquire) != wr_index) {
+    std::unique_lock lock{render_thread.mutex};
+
+    render_thread.cv.wait(lock, [&]() {
+      return render_thread.rd_index.load(std::memory_order_acquire) == wr_index;
+    });
+  }
+}
+
+void PPU::RunRenderThread() {
+  auto& ppu = *render_thread.ppu;
+
+  u64 rd_index = 0U;
+
+  while(true) {
+    if(render_thread.wr_index.load(std::memory_order_acquire) == rd_index) {
+      std::unique_lock lock{render_thread.mutex};
+
+      render_thread.cv.wait(lock, [&]() {
+        return render_thread.quit || render_thread.wr_index.load(std::memory_order_acquire) != rd_index;
+      });
+
+      if(render_thread.wr_index.load(std::memory_order_acquire) == rd_index) {
+        return;
+      }
+    }
+
+    auto& job = render_thread.jobs[rd_index % RenderThread::k_job_count];
+
+    ppu.DrawScanline(job, render_thread.vram_pages.get());
+
+    {
+      std::lock_guard lock{render_thread.mutex};
+      render_thread.vram_page_rd_index.store(job.vram_page_index + job.vram_page_count, std::memory_order_release);
+      render_thread.rd_index.store(++rd_index, std::memory_order_release);
+    }
+    render_thread.cv.notify_all();
+  }
+}
+
+// Records the state that the scanline renderer would read at this point and passes it to the render thread.
+void PPU::SubmitScanline(bool draw_scanline, bool draw_sprites) {
+  const u64 wr_index = render_thread.wr_index.load(std::memory_order_relaxed);
+  const u64 vram_page_index = render_thread.vram_page_wr_index;
+
+  uint vram_page_count = 0U;
+
+  for(u64 dirty : render_thread.dirty_vram) {
+    for(; dirty != 0U; dirty &= dirty - 1U) {
+      vram_page_count++;
+    }
+  }
+
+  const auto CanSubmit = [&]() {
+    return wr_index - render_thread.rd_index.load(std::memory_order_acquire) < RenderThread::k_job_count &&
+           vram_page_index + vram_page_count - render_thread.vram_page_rd_index.load(std::memory_order_acquire) <= RenderThread::k_vram_page_count;
+  };
+
+  // Wait until the render thread has finished enough jobs, if all jobs or too many VRAM pages are in use.
+  if(!CanSubmit()) {
+    std::unique_lock lock{render_thread.mutex};
+
+    render_thread.cv.wait(lock, CanSubmit);
+  }
+
+  auto& job = render_thread.jobs[wr_index % RenderThread::k_job_count];
+
+  if(draw_scanline) {
+    DrawWindow();
+  }
+
+  if(draw_sprites) {
+    InitSprite();
+  }
+
+  job.draw_scanline = draw_scanline;
+  job.draw_sprites = draw_sprites;
+  job.frame = frame;
+  job.mmio = mmio;
+
+  for(int id = 0; id < 2; id++) {
+    job.bg_x[id] = bg.affine[id].x;
+    job.bg_y[id] = bg.affine[id].y;
+  }
+
+  job.window = window;
+
+  job.sprite_vcount = sprite.vcount;
+  job.sprite_mosaic_y = sprite.mosaic_y;
+  job.sprite_latch_cycle_limit = sprite.latch_cycle_limit;
+
+  for(int i = 0; i < 2; i++) {
+    job.dirty_objects[i] = sprite.dirty_objects[i];
+    job.dirty_vram[i] = render_thread.dirty_vram[i];
+    sprite.dirty_objects[i] = 0U;
+    render_thread.dirty_vram[i] = 0U;
+  }
+
+  std::memcpy(job.pram, pram, 0x00400);
+  std::memcpy(job.oam,  oam,  0x00400);
+
+  job.vram_page_index = vram_page_index;
+  job.vram_page_count = vram_page_count;
+
+  u64 page_index = vram_page_index;
+
+  for(uint word = 0; word < 2U; word++) {
+    u64 dirty = job.dirty_vram[word];
+
+    while(dirty != 0U) {
+      const u32 address = ((word << 6) | (uint)count_trailing_zeros64(dirty)) << 10;
+      u8* page = &render_thread.vram_pages[(page_index++ % RenderThread::k_vram_page_count) << 10];
+
+      std::memcpy(page, &vram[address], 0x400);
+
+      dirty &= dirty - 1U;
+    }
+  }
+
+  render_thread.vram_page_wr_index = page_index;
+
+  {
+    std::lock_guard lock{render_thread.mutex};
+    render_thread.wr_index.store(wr_index + 1U, std::memory_order_release);
+  }
+  render_thread.cv.notify_all();
+
+  // The emulation thread keeps track of the OBJ mosaic counter, because the next scanline depends on it.
+  if(draw_sprites) {
+    EndSpriteLine();
+  }
+}
+
+// Runs on the render thread's PPU and draws a scanline like RenderScanline() does.
+void PPU::DrawScanline(RenderThread::Job const& job, u8 const* vram_pages) {
+  mmio = job.mmio;
+  frame = job.frame;
+
+  std::memcpy(pram, job.pram, 0x00400);
+  std::memcpy(oam,  job.oam,  0x00400);
+
+  u64 page_index = job.vram_page_index;
+
+  for(uint word = 0; word < 2U; word++) {
+    u64 dirty = job.dirty_vram[word];
+
+    while(dirty != 0U) {
+      const u32 address = ((word << 6) | (uint)count_trailing_zeros64(dirty)) << 10;
+      u8 const* page = &vram_pages[(page_index++ % RenderThread::k_vram_page_count) << 10];
+
+      std::memcpy(&vram[address], page, 0x400);
+      tile_cache.Invalidate(address, address + 0x400);
+
+      dirty &= dirty - 1U;
+    }
+
+    sprite.dirty_objects[word] |= job.dirty_objects[word];
+  }
+
+  if(job.draw_scanline) {
+    bg.cycle = 0U;
+
+    for(auto& text : bg.text) {
+      text.fetches = 0;
+    }
+
+    for(int id = 0; id < 2; id++) {
+      bg.affine[id].x = job.bg_x[id];
+      bg.affine[id].y = job.bg_y[id];
+    }
+
+    window = job.window;
+
+    RenderScanlineBackground();
+    RenderScanlineMerge();
+    EndMergeLine();
+  }
+
+  if(job.draw_sprites) {
+    sprite.vcount = job.sprite_vcount;
+    sprite.mosaic_y = job.sprite_mosaic_y;
+    sprite.latch_cycle_limit = job.sprite_latch_cycle_limit;
+
+    std::memset(sprite.buffer_wr, 0, sizeof(Sprite::Pixel) * 240);
+
+    RenderScanlineSprites();
+    std::swap(sprite.buffer_rd, sprite.buffer_wr);
+  }
+}
+
+} // namespace nba::core
@@ -0,0 +1,862 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "ppu.hpp"
+
+/* The scanline renderer draws a whole scanline at the start of H-blank, using the PPU state at that point.
+ * For scanlines without mid-scanline changes the output matches the cycle renderer exactly.
+ * Like on hardware the sprites of a scanline are drawn during the previous scanline, and sprites
+ * that would not fit into the sprite engine's cycle budget are cut off the same way.
+ */
+
+namespace nba::core {
+
+void PPU::RenderScanline() {
+  /* Skipped frames only keep the OBJ mosaic counter up to date, which the following scanlines depend on.
+   * The last scanline is drawn regardless, because the BG fetches of the next frame can return the last halfword it fetched.
+   */
+  if(skip_frame && mmio.vcount != 159U) {
+    if(mmio.vcount < 159U) {
+      InitSprite();
+      EndSpriteLine();
+    }
+    return;
+  }
+
+  if(render_thread.ppu) {
+    SubmitScanline(true, mmio.vcount < 159U);
+    return;
+  }
+
+  RenderScanlineBackground();
+  DrawWindow();
+  RenderScanlineMerge();
+  EndMergeLine();
+
+  if(mmio.vcount < 159U) {
+    InitSprite();
+    RenderScanlineSprites();
+    std::swap(sprite.buffer_rd, sprite.buffer_wr);
+  }
+}
+
+/* The cycle renderer draws a scanline in one go as well, if the PPU was not synced during the scanline.
+ * Then the PPU state was the same in every cycle of the scanline and the result is bit-identical.
+ */
+void PPU::FinishBackground() {
+  if(bg.cycle == 0U) {
+    if(!skip_frame || mmio.vcount == 159U) {
+      RenderScanlineBackground();
+    }
+    EndBackgroundLine(mmio.dispcnt.mode, mmio.dispcnt_latch[0] & mmio.dispcnt.hword);
+    bg.cycle = 1232U;
+  } else {
+    DrawBackground();
+  }
+}
+
+void PPU::FinishMerge() {
+  if(merge.cycle == 0U) {
+    if(!skip_frame) {
+      RenderScanlineMerge();
+      EndMergeLine();
+    }
+    merge.cycle = 1006U;
+  } else {
+    DrawMerge();
+  }
+}
+
+void PPU::FinishSprite() {
+  if(sprite.cycle == 0U) {
+    if(!skip_frame) {
+      RenderScanlineSprites();
+    } else {
+      EndSpriteLine();
+    }
+  } else {
+    DrawSprite();
+  }
+}
+
+void PPU::RenderScanlineBackground() {
+  if(ForcedBlank()) {
+    return;
+  }
+
+  switch(mmio.dispcnt.mode) {
+    case 0: RenderScanlineBackgroundImpl<0>(); break;
+    case 1: RenderScanlineBackgroundImpl<1>(); break;
+    case 2: RenderScanlineBackgroundImpl<2>(); break;
+    case 3: RenderScanlineBackgroundImpl<3>(); break;
+    case 4: RenderScanlineBackgroundImpl<4>(); break;
+    case 5: RenderScanlineBackgroundImpl<5>(); break;
+  }
+}
+
+template<int mode> void PPU::RenderScanlineBackgroundImpl() {
+  const u16 latched_dispcnt_and_current_dispcnt = mmio.dispcnt_latch[0] & mmio.dispcnt.hword;
+
+  /* A fetch beyond the BG VRAM returns the last halfword that any BG fetched before it,
+   * so the halfword fetched last in the scanline (by cycle) has to be latched as well.
+   */
+  const u16 vram_bg_latch_old = vram_bg_latch;
+
+  uint latch_cycle = 0U;
+
+  if constexpr(mode <= 1) {
+    bool exact = true;
+
+    for(int id = 0; id < (mode == 0 ? 4 : 2); id++) {
+      if(latched_dispcnt_and_current_dispcnt & (256U << id)) {
+        exact &= RenderScanlineTextBG(id, latch_cycle);
+      }
+    }
+
+    // Which halfword a fetch beyond the BG VRAM returns depends on the exact order of all fetches.
+    if(!exact) {
+      vram_bg_latch = vram_bg_latch_old;
+      bg.cycle = 0U;
+      DrawBackgroundCycles(1231);
+      return;
+    }
+  }
+
+  if constexpr(mode == 1 || mode == 2) {
+    for(int id = 0; id < (mode == 2 ? 2 : 1); id++) {
+      if(latched_dispcnt_and_current_dispcnt & (1024U << id)) {
+        RenderScanlineAffineBG(id, latch_cycle);
+      }
+    }
+  }
+
+  if constexpr(mode >= 3) {
+    if(latched_dispcnt_and_current_dispcnt & 1024U) {
+      RenderScanlineBitmapBG<mode>(latch_cycle);
+    }
+  }
+}
+
+void ALWAYS_INLINE PPU::LatchScanlineFetch(uint cycle, u32 address, uint& latch_cycle) {
+  if(cycle > latch_cycle) {
+    vram_bg_latch = read<u16>(vram, address & ~1U);
+    latch_cycle = cycle;
+  }
+}
+
+bool PPU::RenderScanlineTextBG(int id, uint& latch_cycle) {
+  const auto& bgcnt = mmio.bgcnt[id];
+
+  const u32 tile_base = bgcnt.tile_block << 14;
+  const u32 boundary = GetSpriteVRAMBoundary();
+
+  const uint bghofs = mmio.bghofs[id];
+
+  uint line = mmio.vcount + mmio.bgvofs[id];
+
+  if(bgcnt.mosaic_enable) {
+    line -= (uint)mmio.mosaic.bg._counter_y;
+  }
+
+  const uint grid_y = line >> 3;
+  const uint tile_y = line & 7U;
+  const uint screen_y = (grid_y >> 5) & 1U;
+
+  bool exact = true;
+
+  const auto Fetch = [&](u32 address) -> u16 {
+    if(likely(address < boundary)) {
+      return read<u16>(vram, address);
+    }
+    exact = false;
+    return 0U;
+  };
+
+  uint last_fetch_cycle = 0U;
+  u32 last_fetch_address = 0U;
+
+  uint grid_x = bghofs >> 3;
+
+  /* The map entry of the tile starting at screen X coordinate 'x' is fetched in cycle 4 * (x + 8) + id.
+   * Map fetches happen up until cycle 1006, so up to two tiles past the right edge of the screen are fetched,
+   * but the tile data only is fetched when the map entry was fetched before cycle 1004.
+   */
+  for(int x = -(int)(bghofs & 7U); 4 * (x + 8) + id < 1007; x += 8) {
+    const uint map_fetch_cycle = 4 * (x + 8) + id;
+
+    uint map_block = bgcnt.map_block;
+
+    const uint screen_x = (grid_x >> 5) & 1U;
+
+    switch(bgcnt.size) {
+      case 1: map_block += screen_x; break;
+      case 2: map_block += screen_y; break;
+      case 3: map_block += screen_x + (screen_y << 1); break;
+    }
+
+    const u32 map_address = (map_block << 11) + ((grid_y & 31U) << 6) + ((grid_x & 31U) << 1);
+    const u16 tile = Fetch(map_address);
+
+    if(map_fetch_cycle >= 1004U) {
+      last_fetch_cycle = map_fetch_cycle;
+      last_fetch_address = map_address;
+      break;
+    }
+
+    const uint number = tile & 0x3FFU;
+    const bool flip_x = tile & (1U << 10);
+    const bool flip_y = tile & (1U << 11);
+
+    const uint real_tile_y = flip_y ? (7 - tile_y) : tile_y;
+
+    u32 indices[8];
+
+    // The tile data is fetched one halfword every 4 (4BPP) or 2 (8BPP) pixels, in reverse order if the tile is flipped.
+    if(bgcnt.full_palette) {
+      const u32 address = tile_base + (number << 6) + (real_tile_y << 3);
+
+      // The halfwords of a tile row are either all inside or all outside of the BG VRAM.
+      if(likely(address < boundary)) {
+        const u8* row = tile_cache.GetTile8BPP(address);
+
+        for(int i = 0; i < 8; i++) {
+          indices[i] = row[i];
+        }
+      } else {
+        exact = false;
+      }
+
+      last_fetch_cycle = map_fetch_cycle + 28U;
+      last_fetch_address = flip_x ? address : (address + 6U);
+    } else {
+      const u32 address = tile_base + (number << 5) + (real_tile_y << 2);
+      const uint palette = (tile >> 12) << 4;
+
+      if(likely(address < boundary)) {
+        const u8* row = tile_cache.GetTile4BPP(address);
+
+        for(int i = 0; i < 8; i++) {
+          const uint index = row[i];
+
+          indices[i] = index != 0U ? (index | palette) : 0U;
+        }
+      } else {
+        exact = false;
+      }
+
+      last_fetch_cycle = map_fetch_cycle + 20U;
+      last_fetch_address = flip_x ? address : (address + 2U);
+    }
+
+    if(flip_x) {
+      std::reverse(std::begin(indices), std::end(indices));
+    }
+
+    const int i_min = std::max(0, -x);
+    const int i_max = std::min(8, 240 - x);
+
+    for(int i = i_min; i < i_max; i++) {
+      bg.buffer[x + i][id] = indices[i];
+    }
+
+    grid_x++;
+  }
+
+  if(exact) {
+    LatchScanlineFetch(last_fetch_cycle, last_fetch_address, latch_cycle);
+  }
+
+  return exact;
+}
+
+void PPU::RenderScanlineAffineBG(int id, uint& latch_cycle) {
+  const auto& bgcnt = mmio.bgcnt[2 + id];
+
+  const int log_size = bgcnt.size;
+  const s32 size = 128 << log_size;
+  const s32 mask = size - 1;
+
+  const u32 map_base = bgcnt.map_block << 11;
+  const u32 tile_base = bgcnt.tile_block << 14;
+
+  const s32 bgpa = mmio.bgpa[id];
+  const s32 bgpc = mmio.bgpc[id];
+
+  s32 ref_x = bg.affine[id].x;
+  s32 ref_y = bg.affine[id].y;
+
+  const auto GetMapAddress = [&](s32 tx, s32 ty) -> u16 {
+    return map_base + ((ty >> 3) << (4 + log_size)) + (tx >> 3);
+  };
+
+  for(int x = 0; x < 240; x++) {
+    s32 tx = ref_x >> 8;
+    s32 ty = ref_y >> 8;
+
+    ref_x += bgpa;
+    ref_y += bgpc;
+
+    if(bgcnt.wraparound) {
+      tx &= mask;
+      ty &= mask;
+    } else if(((tx | ty) & -size) != 0) {
+      bg.buffer[x][2 + id] = 0U;
+      continue;
+    }
+
+    const u16 map_address = GetMapAddress(tx, ty);
+    const u16 tile_address = tile_base + (vram[map_address] << 6) + ((ty & 7) << 3) + (tx & 7);
+
+    bg.buffer[x][2 + id] = vram[tile_address];
+  }
+
+  /* The last fetch is the fetch of the map entry (BG2, cycle 1006) or the tile data (BG3, cycle 1005)
+   * for the 244th pixel. It also happens for pixels outside of the BG.
+   */
+  s32 tx = (ref_x + 3 * bgpa) >> 8;
+  s32 ty = (ref_y + 3 * bgpc) >> 8;
+
+  if(bgcnt.wraparound) {
+    tx &= mask;
+    ty &= mask;
+  }
+
+  const u16 map_address = GetMapAddress(tx, ty);
+
+  if(id == 0) {
+    LatchScanlineFetch(1006U, map_address, latch_cycle);
+  } else {
+    LatchScanlineFetch(1005U, (u16)(tile_base + (vram[map_address] << 6) + ((ty & 7) << 3) + (tx & 7)), latch_cycle);
+  }
+}
+
+template<int mode> void PPU::RenderScanlineBitmapBG(uint& latch_cycle) {
+  const s32 bgpa = mmio.bgpa[0];
+  const s32 bgpc = mmio.bgpc[0];
+
+  const u32 frame_base = mmio.dispcnt.frame * 0xA000U;
+
+  const auto GetAddress = [&](s32 tx, s32 ty) -> u32 {
+    if constexpr(mode == 3) return (((u32)ty * 240U + (u32)tx) * 2U) & 0x1FFFFU;
+    if constexpr(mode == 4) return (frame_base + (u32)ty * 240U + (u32)tx) & 0x1FFFFU;
+    if constexpr(mode == 5) return (frame_base + ((u32)ty * 160U + (u32)tx) * 2U) & 0x1FFFFU;
+  };
+
+  s32 ref_x = bg.affine[0].x;
+  s32 ref_y = bg.affine[0].y;
+
+  for(int x = 0; x < 240; x++) {
+    const s32 tx = ref_x >> 8;
+    const s32 ty = ref_y >> 8;
+
+    ref_x += bgpa;
+    ref_y += bgpc;
+
+    u32 color = 0U;
+
+    if constexpr(mode == 3) {
+      if(tx >= 0 && tx < 240 && ty >= 0 && ty < 160) {
+        color = read<u16>(vram, GetAddress(tx, ty)) | 0x8000'0000;
+      }
+    }
+
+    if constexpr(mode == 4) {
+      if(tx >= 0 && tx < 240 && ty >= 0 && ty < 160) {
+        color = vram[GetAddress(tx, ty)];
+      }
+    }
+
+    if constexpr(mode == 5) {
+      if(tx >= 0 && tx < 160 && ty >= 0 && ty < 128) {
+        color = read<u16>(vram, GetAddress(tx, ty)) | 0x8000'0000;
+      }
+    }
+
+    bg.buffer[x][2] = color;
+  }
+
+  /* The last fetch happens for the 243rd pixel in cycle 1003. Pixels outside of the bitmap
+   * are fetched as well, unless their address lies beyond the BG VRAM.
+   */
+  for(int x = 242; x >= 0; x--) {
+    const u32 address = GetAddress((bg.affine[0].x + x * bgpa) >> 8, (bg.affine[0].y + x * bgpc) >> 8);
+
+    if(address < 0x14000U) {
+      LatchScanlineFetch(35U + x * 4U, address, latch_cycle);
+      break;
+    }
+  }
+}
+
+void PPU::RenderScanlineMerge() {
+  static constexpr int k_min_max_bg[8][2] {
+    {0,  3}, // Mode 0 (BG0 - BG3 text-mode)
+    {0,  2}, // Mode 1 (BG0 - BG1 text-mode, BG2 affine)
+    {2,  3}, // Mode 2 (BG2 - BG3 affine)
+    {2,  2}, // Mode 3 (BG2 240x160 65526-color bitmap)
+    {2,  2}, // Mode 4 (BG2 240x160 256-color bitmap, double-buffered)
+    {2,  2}, // Mode 5 (BG2 160x128 65536-color bitmap, double-buffered)
+    {0, -1}, // Mode 6 (invalid)
+    {0, -1}, // Mode 7 (invalid)
+  };
+
+  u32* out = &output[frame][mmio.vcount * 240];
+
+  if(ForcedBlank()) {
+    std::fill_n(out, 240, RGB555ToARGB8888(0x7FFFU));
+    return;
+  }
+
+  const int mode = mmio.dispcnt.mode;
+
+  const int min_bg = k_min_max_bg[mode][0];
+  const int max_bg = k_min_max_bg[mode][1];
+
+  const u16 latched_dispcnt_and_current_dispcnt = mmio.dispcnt_latch[0] & mmio.dispcnt.hword;
+
+  // Enabled BGs sorted from highest to lowest priority.
+  int bg_list[4];
+  int bg_count = 0;
+
+  for(int priority = 0; priority <= 3; priority++) {
+    for(int id = min_bg; id <= max_bg; id++) {
+      if(mmio.bgcnt[id].priority == priority && (latched_dispcnt_and_current_dispcnt & (256U << id))) {
+        bg_list[bg_count++] = id;
+      }
+    }
+  }
+
+  const bool enable_obj = latched_dispcnt_and_current_dispcnt & (256U << LAYER_OBJ);
+
+  const bool enable_win0 = mmio.dispcnt.enable[ENABLE_WIN0];
+  const bool enable_win1 = mmio.dispcnt.enable[ENABLE_WIN1];
+  const bool enable_objwin = mmio.dispcnt.enable[ENABLE_OBJWIN] && enable_obj;
+
+  const bool have_windows = enable_win0 || enable_win1 || enable_objwin;
+
+  const int* win_layer_enable = mmio.winout.enable[0];
+
+  const auto& bldcnt = mmio.bldcnt;
+
+  uint mosaic_x[2] {0U, 0U};
+  Sprite::Pixel sprite_pixel_latch{};
+
+  // The color effects are applied to the whole scanline at once, after the layers of every pixel were selected.
+  u16 line[240];
+  u16 line_b[240];
+  ColorEffect effects[240];
+
+  for(uint x = 0; x < 240; x++) {
+    if(have_windows) {
+      win_layer_enable = GetWindowLayerEnable(x, enable_win0, enable_win1, enable_objwin);
+    }
+
+    uint priorities[2] {3U, 3U};
+    int layers[2] {LAYER_BD, LAYER_BD};
+    u32 colors[2] {0U, 0U};
+
+    int bg_list_index = 0;
+
+    for(int j = 0; j < 2; j++) {
+      while(bg_list_index < bg_count) {
+        const int bg_id = bg_list[bg_list_index];
+
+        bg_list_index++;
+
+        if(!have_windows || win_layer_enable[bg_id]) {
+          const auto& bgcnt = mmio.bgcnt[bg_id];
+          const uint mx = x - (bgcnt.mosaic_enable ? mosaic_x[0] : 0U);
+          const u32 bg_color = bg.buffer[mx][bg_id];
+
+          if(bg_color != 0U) {
+            layers[j] = bg_id;
+            colors[j] = bg_color;
+            priorities[j] = (uint)bgcnt.priority;
+            break;
+          }
+        }
+      }
+    }
+
+    bool force_alpha_blend = false;
+
+    const auto current_sprite_pixel = enable_obj ? sprite.buffer_rd[x] : Sprite::Pixel{};
+
+    if(!current_sprite_pixel.mosaic || !sprite_pixel_latch.mosaic || mosaic_x[1] == 0U) {
+      sprite_pixel_latch = current_sprite_pixel;
+    }
+
+    if(enable_obj && (!have_windows || win_layer_enable[LAYER_OBJ])) {
+      const auto pixel = sprite_pixel_latch;
+
+      if(pixel.color != 0U) {
+        if(pixel.priority <= priorities[0]) {
+          layers[1] = layers[0];
+          colors[1] = colors[0];
+          layers[0] = LAYER_OBJ;
+          colors[0] = pixel.color | 256U;
+
+          force_alpha_blend = pixel.alpha;
+        } else if(pixel.priority <= priorities[1]) {
+          layers[1] = LAYER_OBJ;
+          colors[1] = pixel.color | 256U;
+        }
+      }
+    }
+
+    // Colors with bit 31 set are direct colors from a bitmap BG, all other colors are palette indices.
+    const auto Resolve = [&](u32 color) -> u16 {
+      if((color & 0x8000'0000) == 0) {
+        return read<u16>(pram, color << 1);
+      }
+      return (u16)color;
+    };
+
+    ColorEffect effect = ColorEffect::None;
+
+    const bool have_src = bldcnt.targets[1][layers[1]];
+
+    if(force_alpha_blend && have_src) {
+      effect = ColorEffect::Blend;
+    } else if(!have_windows || win_layer_enable[LAYER_SFX]) {
+      if(bldcnt.targets[0][layers[0]]) {
+        switch(bldcnt.sfx) {
+          case BlendControl::SFX_BLEND: {
+            if(have_src) {
+              effect = ColorEffect::Blend;
+            }
+            break;
+          }
+          case BlendControl::SFX_BRIGHTEN: effect = ColorEffect::Brighten; break;
+          case BlendControl::SFX_DARKEN:   effect = ColorEffect::Darken; break;
+          case BlendControl::SFX_NONE: break;
+        }
+      }
+    }
+
+    line[x] = Resolve(colors[0]);
+    line_b[x] = effect == ColorEffect::Blend ? Resolve(colors[1]) : 0U;
+    effects[x] = effect;
+
+    if(++mosaic_x[0] == (uint)mmio.mosaic.bg.size_x) {
+      mosaic_x[0] = 0U;
+    }
+
+    if(++mosaic_x[1] == (uint)mmio.mosaic.obj.size_x) {
+      mosaic_x[1] = 0U;
+    }
+  }
+
+  ApplyColorEffects(line, line_b, effects, 240, mmio.eva, mmio.evb, mmio.evy);
+
+  if(mmio.greenswap & 1) {
+    const u16 mask = 31U << 5;
+
+    for(int x = 0; x < 240; x += 2) {
+      const u16 g_l = line[x + 0] & mask;
+      const u16 g_r = line[x + 1] & mask;
+
+      line[x + 0] = (line[x + 0] & ~mask) | g_r;
+      line[x + 1] = (line[x + 1] & ~mask) | g_l;
+    }
+  }
+
+  ConvertRGB555ToARGB8888(out, line, 240);
+}
+
+void PPU::RenderScanlineSprites() {
+  static constexpr int k_sprite_size[4][4][2] = {
+    { { 8 , 8  }, { 16, 16 }, { 32, 32 }, { 64, 64 } }, // Square
+    { { 16, 8  }, { 32, 8  }, { 32, 16 }, { 64, 32 } }, // Horizontal
+    { { 8 , 16 }, { 8 , 32 }, { 16, 32 }, { 32, 64 } }, // Vertical
+    { { 8 , 8  }, { 8 , 8  }, { 8 , 8  }, { 8 , 8  } }  // Prohibited
+  };
+
+  const uint vcount = sprite.vcount;
+  const uint cycle_limit = sprite.latch_cycle_limit;
+
+  if(mmio.dispcnt.enable[LAYER_OBJ]) {
+    const u32 boundary = GetSpriteVRAMBoundary();
+    const bool oam_mapping_1d = mmio.dispcnt.oam_mapping_1d;
+    const int mosaic_y = sprite.mosaic_y;
+
+    /* The sprite engine does one OAM fetch step and draws up to two pixels every two cycles.
+     * An OBJ is only drawn once all of its attributes have been fetched and the drawing
+     * of the next OBJ overlaps with the attribute fetches of the OBJ after it.
+     */
+    const int step_limit = (int)cycle_limit / 2;
+
+    int step = 0;
+    int pending_wait = 0;
+
+    UpdateSpriteLines();
+
+    const u64* line_objects = sprite.line_objects[vcount];
+
+    const auto FindObject = [&](uint index) -> uint {
+      while(index < 128U) {
+        const u64 objects = line_objects[index >> 6] >> (index & 63U);
+
+        if(objects != 0U) {
+          return index + (uint)count_trailing_zeros64(objects);
+        }
+
+        index = (index | 63U) + 1U;
+      }
+
+      return 128U;
+    };
+
+    uint index_next = 0U;
+
+    // Only the OBJs that are enabled and intersect the scanline are decoded.
+    for(uint index = FindObject(0U); index < 128U; index = FindObject(index + 1U)) {
+      // The OAM entries in between still take one fetch step each.
+      if(index > index_next) {
+        step += (int)(index - index_next) + pending_wait;
+        pending_wait = 0;
+      }
+
+      if(step >= step_limit) {
+        break;
+      }
+
+      // The wait for the OBJ that is being drawn begins after the first fetch step.
+      step += 1 + pending_wait;
+      pending_wait = 0;
+
+      index_next = index + 1U;
+
+      const u32 attr01 = read<u32>(oam, index * 8U);
+
+      const uint mode = (attr01 >> 10) & 3U;
+
+      s32 x = (attr01 >> 16) & 0x1FF;
+      s32 y =  attr01 & 0xFF;
+
+      if(x >= 240) x -= 512;
+
+      const uint shape = (attr01 >> 14) & 3U;
+      const uint size  =  attr01 >> 30;
+
+      const int width  = k_sprite_size[shape][size][0];
+      const int height = k_sprite_size[shape][size][1];
+
+      int half_width  = width  >> 1;
+      int half_height = height >> 1;
+
+      const bool affine = attr01 & 0x100U;
+
+      if(affine && (attr01 & 0x200U)) {
+        half_width  *= 2;
+        half_height *= 2;
+      }
+
+      int draw_x = x;
+      int remaining_pixels = half_width << 1;
+      int clip = 0;
+
+      if(x < 0) {
+        clip = -x & (affine ? ~0 : ~1);
+
+        draw_x += clip;
+        remaining_pixels -= clip;
+
+        if(remaining_pixels <= 0) {
+          continue;
+        }
+      }
+
+      // Attribute #2 and for affine OBJs the four matrix components are fetched in separate steps.
+      const int submit_step = step + (affine ? 4 : 0);
+
+      if(submit_step >= step_limit) {
+        break;
+      }
+
+      step = submit_step + 1;
+
+      const bool mosaic = (attr01 & (1 << 12)) && mode != OBJ_WINDOW;
+      const bool is_256 = (attr01 >> 13) & 1;
+
+      int local_y = (vcount - y) & 255;
+
+      if(mosaic) {
+        local_y = std::max(0, local_y - mosaic_y);
+      }
+
+      const u16 attr2 = read<u16>(oam, index * 8U + 4U);
+
+      const uint base_tile = attr2 & 0x3FFU;
+      const uint priority = (attr2 >> 10) & 3U;
+      const uint palette = is_256 ? 0U : (attr2 >> 12) << 4;
+
+      const auto CalculateTileNumber = [&](int block_x, int block_y) -> uint {
+        if(is_256) {
+          if(oam_mapping_1d) {
+            return (base_tile + block_y * ((uint)width >> 2) + (block_x << 1)) & 0x3FFU;
+          }
+          return ((base_tile + (block_y << 5)) & 0x3E0U) | (((base_tile & ~1) + (block_x << 1)) & 0x1FU);
+        }
+
+        if(oam_mapping_1d) {
+          return (base_tile + block_y * ((uint)width >> 3) + block_x) & 0x3FFU;
+        }
+        return ((base_tile + (block_y << 5)) & 0x3E0U) | ((base_tile + block_x) & 0x1FU);
+      };
+
+      const auto Fetch = [&](uint address) -> uint {
+        return address >= boundary ? vram[address] : 0U;
+      };
+
+      const auto Plot = [&](int x, uint color) {
+        if(x < 0 || x >= 240) return;
+
+        auto& pixel = sprite.buffer_wr[x];
+
+        const bool opaque = color != 0U;
+
+        if(mode == OBJ_WINDOW && opaque) {
+          pixel.window = 1;
+        } else if(priority < pixel.priority || pixel.color == 0U) {
+          if(opaque) {
+            pixel.color = color;
+            pixel.alpha = (mode == OBJ_SEMI) ? 1U : 0U;
+          }
+          pixel.mosaic = mosaic ? 1U : 0U;
+          pixel.priority = priority;
+        }
+      };
+
+      if(affine) {
+        s16 matrix[4];
+
+        for(int i = 0; i < 4; i++) {
+          matrix[i] = read<s16>(oam, (((attr01 >> 25) & 31U) * 32U) + 6U + i * 8U);
+        }
+
+        const int x0 = -half_width + clip;
+        const int y0 = local_y - half_height;
+
+        int texture_x = (matrix[0] * x0 + matrix[1] * y0) + (width  << 7);
+        int texture_y = (matrix[2] * x0 + matrix[3] * y0) + (height << 7);
+
+        // Drawing starts one step late, because the drawer waits for the first fetch step of the next OBJ.
+        const int pixels = std::min(remaining_pixels, step_limit - submit_step - 2);
+
+        for(int i = 0; i < pixels; i++) {
+          const int tex_x = texture_x >> 8;
+          const int tex_y = texture_y >> 8;
+
+          if(tex_x >= 0 && tex_x < width && tex_y >= 0 && tex_y < height) {
+            const int tile_x = tex_x & 7;
+            const int tile_y = tex_y & 7;
+            const uint tile = CalculateTileNumber(tex_x >> 3, tex_y >> 3);
+
+            uint color_index;
+
+            if(is_256) {
+              color_index = Fetch(0x10000U + (tile << 5) + (tile_y << 3) + tile_x);
+            } else {
+              const uint data = Fetch(0x10000U + (tile << 5) + (tile_y << 2) + (tile_x >> 1));
+
+              color_index = (tile_x & 1) ? (data >> 4) : (data & 15U);
+
+              if(color_index > 0U) {
+                color_index |= palette;
+              }
+            }
+
+            Plot(draw_x, color_index);
+          }
+
+          draw_x++;
+
+          texture_x += matrix[0];
+          texture_y += matrix[2];
+        }
+
+        pending_wait = std::max(0, half_width * 2 - 1 - clip);
+      } else {
+        const bool flip_h = attr01 & (1 << 28);
+        const bool flip_v = attr01 & (1 << 29);
+
+        const int tex_y = flip_v ? (local_y ^ (height - 1)) : local_y;
+        const int tile_y = tex_y & 7;
+        const int block_y = tex_y >> 3;
+
+        const int pairs = std::min(remaining_pixels >> 1, step_limit - submit_step - 1);
+
+        int texture_x = clip;
+
+        for(int i = 0; i < pairs; i++) {
+          const int tex_x = texture_x ^ (flip_h ? (width - 1) : 0);
+          const int tile_x = tex_x & 6;
+          const uint tile = CalculateTileNumber(tex_x >> 3, block_y);
+
+          uint color_indices[2];
+
+          if(is_256) {
+            const uint address = 0x10000U + (tile << 5) + (tile_y << 3) + tile_x;
+
+            color_indices[0] = Fetch(address + 0);
+            color_indices[1] = Fetch(address + 1);
+          } else {
+            const uint data = Fetch(0x10000U + (tile << 5) + (tile_y << 2) + (tile_x >> 1));
+
+            color_indices[0] = data & 15U;
+            color_indices[1] = data >> 4;
+          }
+
+          if(flip_h) {
+            std::swap(color_indices[0], color_indices[1]);
+          }
+
+          for(uint color_index : color_indices) {
+            if(color_index > 0U) {
+              color_index |= palette;
+            }
+
+            Plot(draw_x++, color_index);
+          }
+
+          texture_x += 2;
+        }
+
+        pending_wait = std::max(0, half_width - 2 - (clip >> 1));
+      }
+    }
+  }
+
+  EndSpriteLine();
+}
+
+void PPU::EndSpriteLine() {
+  const uint cycle_limit = sprite.latch_cycle_limit;
+
+  // The mosaic counter is advanced in the last cycle of the scanline, which is never reached with 'H-blank interval free'.
+  if(cycle_limit > 1192U) {
+    auto& mosaic = mmio.mosaic;
+
+    if(sprite.vcount < 159U) {
+      if(++mosaic.obj._counter_y == mosaic.obj.size_y) {
+        mosaic.obj._counter_y = 0;
+      } else {
+        mosaic.obj._counter_y &= 15;
+      }
+    } else {
+      mosaic.obj._counter_y = 0;
+    }
+  }
+
+  sprite.cycle = cycle_limit;
+}
+
+} // namespace nba::core
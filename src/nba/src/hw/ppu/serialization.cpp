@@ -64,9 +64,38 @@ void PPU::LoadState(SaveState const& state) {
   std::memcpy(pram, state.bus.memory.pram, 0x400);
   std::memcpy(oam,  state.bus.memory.oam,  0x400);
   std::memcpy(vram, state.bus.memory.vram, 0x18000);
+  tile_cache.Invalidate(0U, 0x18000U);
+
+  sprite.dirty_objects[0] = ~0ULL;
+  sprite.dirty_objects[1] = ~0ULL;
 
   vram_bg_latch = ss_ppu.vram_bg_latch;
+
+  MarkVRAMDirty();
+
+  if(render_thread.ppu) {
+    WaitForRenderThread();
+    render_thread.ppu->vram_bg_latch = vram_bg_latch;
+  }
   dma3_video_transfer_running = ss_ppu.dma3_video_transfer_running;
+
+  // The state may have been saved with the other renderer, so (un)schedule the sprite fetch event to match this one.
+  Scheduler::Event* sprite_fetch_event = nullptr;
+
+  scheduler.ForEachEvent(Scheduler::EventClass::PPU_begin_sprite_fetch, [&](Scheduler::Event* event) {
+    sprite_fetch_event = event;
+  });
+
+  if(scanline_renderer) {
+    if(sprite_fetch_event) {
+      scheduler.Cancel(sprite_fetch_event);
+    }
+  } else if(!sprite_fetch_event) {
+    // The event fires 266 cycles into each scanline, counting from the last reset.
+    const u64 phase = (scheduler.GetTimestampNow() + 1232U - 266U) % 1232U;
+
+    scheduler.Add(1232U - phase, Scheduler::EventClass::PPU_begin_sprite_fetch);
+  }
 }
 
 void PPU::CopyState(SaveState& state) {
@@ -117,7 +146,13 @@ void PPU::CopyState(SaveState& state) {
   std::memcpy(state.bus.memory.oam,  oam,  0x400);
   std::memcpy(state.bus.memory.vram, vram, 0x18000);
 
-  ss_ppu.vram_bg_latch = vram_bg_latch;
+  // With the threaded renderer the latch belongs to the render thread.
+  if(render_thread.ppu) {
+    WaitForRenderThread();
+    ss_ppu.vram_bg_latch = render_thread.ppu->vram_bg_latch;
+  } else {
+    ss_ppu.vram_bg_latch = vram_bg_latch;
+  }
   ss_ppu.dma3_video_transfer_running = dma3_video_transfer_running;
 }
 
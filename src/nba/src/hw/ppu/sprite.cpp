@@ -45,11 +45,76 @@ void PPU::DrawSprite() {
     return;
   }
 
+  UpdateSpriteLines();
   DrawSpriteImpl(cycles);
 
   sprite.timestamp_last_sync = timestamp_now;
 }
 
+/* Keeps track of the scanlines that each OBJ intersects, based on attributes #0 and #1.
+ * Only the OBJs whose attributes were written since the last update are moved to their new scanlines.
+ */
+void PPU::UpdateSpriteLines() {
+  static constexpr int k_sprite_height[4][4] = {
+    { 8 , 16, 32, 64 }, // Square
+    { 8 , 8 , 16, 32 }, // Horizontal
+    { 16, 32, 32, 64 }, // Vertical
+    { 8 , 8 , 8 , 8  }  // Prohibited
+  };
+
+  for(uint word = 0; word < 2U; word++) {
+    u64 dirty = sprite.dirty_objects[word];
+
+    while(dirty != 0U) {
+      const uint index = (word << 6) | (uint)count_trailing_zeros64(dirty);
+      const u64 bit = 1ULL << (index & 63U);
+
+      dirty &= dirty - 1U;
+
+      auto& lines = sprite.object_lines[index];
+
+      for(uint line = lines[0]; line < lines[1]; line++) {
+        sprite.line_objects[line][word] &= ~bit;
+      }
+
+      const u32 attr01 = read<u32>(oam, index * 8U);
+
+      uint line_min = 0U;
+      uint line_max = 0U;
+
+      // @todo: how does HW handle OBJs in prohibited mode?
+      if((attr01 & 0x300U) != 0x200U && ((attr01 >> 10) & 3U) != OBJ_PROHIBITED) {
+        const uint y = attr01 & 0xFFU;
+
+        uint height = k_sprite_height[(attr01 >> 14) & 3U][attr01 >> 30];
+
+        if((attr01 & 0x300U) == 0x300U) { // affine and double-size
+          height *= 2U;
+        }
+
+        const uint y_max = (y + height) & 255U;
+
+        // An OBJ that wraps around at the bottom is only visible on the scanlines above its bottom edge.
+        if(y_max < y) {
+          line_max = std::min(y_max, 160U);
+        } else {
+          line_min = std::min(y, 160U);
+          line_max = std::min(y_max, 160U);
+        }
+      }
+
+      for(uint line = line_min; line < line_max; line++) {
+        sprite.line_objects[line][word] |= bit;
+      }
+
+      lines[0] = (u8)line_min;
+      lines[1] = (u8)line_max;
+    }
+
+    sprite.dirty_objects[word] = 0U;
+  }
+}
+
 void PPU::DrawSpriteImpl(int cycles) {
   const uint cycle_limit = sprite.latch_cycle_limit;
 
@@ -127,99 +192,93 @@ void PPU::DrawSpriteFetchOAM(uint cycle) {
 
       bool active = false;
 
-      if((attr01 & 0x300U) != 0x200U) { // check if the sprite is enabled
+      // Only the OBJs that are enabled and intersect the scanline need to be decoded.
+      if(IsSpriteOnLine(oam_fetch.index)) {
         const uint mode = (attr01 >> 10) & 3U;
 
-        // @todo: how does HW handle OBJs in prohibited mode?
-        if(mode != OBJ_PROHIBITED) {
-          s32 x = (attr01 >> 16) & 0x1FF;
-          s32 y =  attr01 & 0xFF;
+        s32 x = (attr01 >> 16) & 0x1FF;
+        s32 y =  attr01 & 0xFF;
 
-          if(x >= 240) x -= 512;
+        if(x >= 240) x -= 512;
 
-          const uint shape = (attr01 >> 14) & 3U;
-          const uint size  =  attr01 >> 30;
+        const uint shape = (attr01 >> 14) & 3U;
+        const uint size  =  attr01 >> 30;
 
-          const int width  = k_sprite_size[shape][size][0];
-          const int height = k_sprite_size[shape][size][1];
+        const int width  = k_sprite_size[shape][size][0];
+        const int height = k_sprite_size[shape][size][1];
 
-          int half_width  = width  >> 1;
-          int half_height = height >> 1;
+        int half_width  = width  >> 1;
+        int half_height = height >> 1;
 
-          const bool affine = attr01 & 0x100U;
+        const bool affine = attr01 & 0x100U;
 
-          if(affine) {
-            const bool double_size = attr01 & 0x200U;
+        if(affine) {
+          const bool double_size = attr01 & 0x200U;
 
-            if(double_size) {
-              half_width  *= 2;
-              half_height *= 2;
-            }
+          if(double_size) {
+            half_width  *= 2;
+            half_height *= 2;
           }
+        }
 
-          const int vcount = sprite.vcount;
-
-          const int y_max = (y + half_height * 2) & 255;
+        const int vcount = sprite.vcount;
 
-          if((vcount >= y || y_max < y) && vcount < y_max) {
-            const bool mosaic = (attr01 & (1 << 12)) && mode != OBJ_WINDOW;
+        const bool mosaic = (attr01 & (1 << 12)) && mode != OBJ_WINDOW;
 
-            drawer_state.width = width;
-            drawer_state.height = height;
-            drawer_state.mode = mode;
-            drawer_state.mosaic = mosaic;
-            drawer_state.affine = affine;
-            drawer_state.draw_x = x;
-            drawer_state.remaining_pixels = half_width << 1;
+        drawer_state.width = width;
+        drawer_state.height = height;
+        drawer_state.mode = mode;
+        drawer_state.mosaic = mosaic;
+        drawer_state.affine = affine;
+        drawer_state.draw_x = x;
+        drawer_state.remaining_pixels = half_width << 1;
        
-            drawer_state.is_256 = (attr01 >> 13) & 1;
+        drawer_state.is_256 = (attr01 >> 13) & 1;
 
-            int local_y = (vcount - y) & 255;
+        int local_y = (vcount - y) & 255;
 
-            if(mosaic) {
-              local_y = std::max(0, local_y - sprite.mosaic_y);
-            }
+        if(mosaic) {
+          local_y = std::max(0, local_y - sprite.mosaic_y);
+        }
 
-            if(!affine) {
-              const bool flip_v = attr01 & (1 << 29);
+        if(!affine) {
+          const bool flip_v = attr01 & (1 << 29);
 
-              drawer_state.flip_h = attr01 & (1 << 28);
+          drawer_state.flip_h = attr01 & (1 << 28);
 
-              drawer_state.texture_x = 0;
-              drawer_state.texture_y = local_y;
+          drawer_state.texture_x = 0;
+          drawer_state.texture_y = local_y;
 
-              if(flip_v) {
-                drawer_state.texture_y ^= height - 1;
-              }
+          if(flip_v) {
+            drawer_state.texture_y ^= height - 1;
+          }
 
-              oam_fetch.pending_wait = half_width - 2;
-            } else {
-              oam_fetch.initial_local_x = -half_width;
-              oam_fetch.initial_local_y = local_y - half_height;
-              oam_fetch.pending_wait = half_width * 2 - 1;
-              oam_fetch.matrix_address = (((attr01 >> 25) & 31U) * 32U) + 6U;
-            }
+          oam_fetch.pending_wait = half_width - 2;
+        } else {
+          oam_fetch.initial_local_x = -half_width;
+          oam_fetch.initial_local_y = local_y - half_height;
+          oam_fetch.pending_wait = half_width * 2 - 1;
+          oam_fetch.matrix_address = (((attr01 >> 25) & 31U) * 32U) + 6U;
+        }
 
-            active = true;
+        active = true;
 
-            if(x < 0) {
-              const int clip = -x & (affine ? ~0 : ~1);
+        if(x < 0) {
+          const int clip = -x & (affine ? ~0 : ~1);
 
-              drawer_state.draw_x += clip;
-              drawer_state.remaining_pixels -= clip;
+          drawer_state.draw_x += clip;
+          drawer_state.remaining_pixels -= clip;
 
-              if(affine) {
-                oam_fetch.pending_wait -= clip;
-                oam_fetch.initial_local_x += clip;
-              } else {
-                oam_fetch.pending_wait -= clip >> 1;
-                drawer_state.texture_x += clip;
-              }
+          if(affine) {
+            oam_fetch.pending_wait -= clip;
+            oam_fetch.initial_local_x += clip;
+          } else {
+            oam_fetch.pending_wait -= clip >> 1;
+            drawer_state.texture_x += clip;
+          }
 
-              if(drawer_state.remaining_pixels <= 0) {
-                active = false;
-              }
-            }
+          if(drawer_state.remaining_pixels <= 0) {
+            active = false;
           }
         }
       }
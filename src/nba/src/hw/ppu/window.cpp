@@ -5,10 +5,68 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
+
 #include "ppu.hpp"
 
+/* While a scanline is drawn the window unit only depends on WINxH, since WINxV is evaluated once at the start of the scanline.
+ * This means that the window mask of a scanline can be drawn in one step, as a few spans between the left and right edges,
+ * and only needs to be split where WINxH is written mid-scanline. The window unit checks one pixel every four cycles.
+ */
+
 namespace nba::core {
 
+/* Walks the pixels [x_min, x_max) with a constant window range and calls span(x0, x1, h_flag) for
+ * every span of pixels that have the same horizontal window flag. Returns the flag after the last pixel.
+ */
+template<typename Functor>
+static bool WalkWindowSpans(WindowRange const& winh, bool h_flag, uint x_min, uint x_max, Functor&& span) {
+  const uint min = (uint)winh.min;
+  const uint max = (uint)winh.max;
+
+  uint x = x_min;
+
+  while(x < x_max) {
+    uint x_edge = x_max;
+
+    if(min >= x && min < x_edge) x_edge = min;
+    if(max >= x && max < x_edge) x_edge = max;
+
+    span(x, x_edge, h_flag);
+
+    if(x_edge == x_max) {
+      break;
+    }
+
+    // If both edges are on the same pixel, the right edge is checked last.
+    if(x_edge == min) h_flag = true;
+    if(x_edge == max) h_flag = false;
+
+    span(x_edge, x_edge + 1U, h_flag);
+
+    x = x_edge + 1U;
+  }
+
+  return h_flag;
+}
+
+static void FillWindowMask(u64* mask, uint x_min, uint x_max, bool inside) {
+  for(uint x = x_min; x < x_max;) {
+    const uint word = x >> 6;
+    const uint x_next = std::min(x_max, (word + 1U) << 6);
+    const uint bit_count = x_next - x;
+    const u64 bits = (bit_count == 64U ? ~0ULL : ((1ULL << bit_count) - 1U)) << (x & 63U);
+
+    if(inside) {
+      mask[word] |= bits;
+    } else {
+      mask[word] &= ~bits;
+    }
+
+    x = x_next;
+  }
+}
+
 void PPU::InitWindow() {
   const int vcount = mmio.vcount;
 
@@ -24,46 +82,62 @@ void PPU::InitWindow() {
     }
   }
 
-  window.timestamp_last_sync = scheduler.GetTimestampNow();
-  window.cycle = 0;
+  window.timestamp_init = scheduler.GetTimestampNow();
+  window.x_begin = 0U;
+  window.dirty = true;
 }
 
 void PPU::DrawWindow() {
-  const u64 timestamp_now = scheduler.GetTimestampNow();
+  if(!window.dirty) {
+    return;
+  }
 
-  const int cycles = (int)(timestamp_now - window.timestamp_last_sync);
+  const uint x_min = std::min(window.x_begin, 240U);
 
-  if(cycles == 0 || window.cycle >= 1024U) {
-    return;
+  for(int i = 0; i < 2; i++) {
+    u64* mask = window.mask[i];
+
+    if(!window.v_flag[i]) {
+      FillWindowMask(mask, x_min, 240U, false);
+      continue;
+    }
+
+    WalkWindowSpans(mmio.winh[i], window.h_flag[i], x_min, 240U, [&](uint x0, uint x1, bool inside) {
+      FillWindowMask(mask, x0, x1, inside);
+    });
   }
 
-  for(int i = 0; i < cycles; i++) {
-    if((window.cycle & 3U) == 0U) {
-      const uint x = window.cycle >> 2;
+  window.dirty = false;
+}
 
-      for(int i = 0; i < 2; i++) {
-        const auto& winh = mmio.winh[i];
+void PPU::AdvanceWindow(uint x) {
+  DrawWindow();
 
-        if(x == winh.min) {
-          window.h_flag[i] = true;
-        }
+  for(int i = 0; i < 2; i++) {
+    window.h_flag[i] = WalkWindowSpans(mmio.winh[i], window.h_flag[i], window.x_begin, x, [](uint, uint, bool) {});
+  }
 
-        if(x == winh.max) {
-          window.h_flag[i] = false;
-        }
+  window.x_begin = x;
+}
 
-        if(x < 240) {
-          window.buffer[x][i] = window.h_flag[i] && window.v_flag[i];
-        }
-      }
-    }
+void PPU::EndWindow() {
+  AdvanceWindow(256U);
+}
 
-    if(++window.cycle == 1024U) {
-      break;
-    }
+void PPU::OnWindowRangeWrite() {
+  if(scanline_renderer) {
+    return;
+  }
+
+  // The pixels that the window unit has checked up to now keep the old window range.
+  const u64 cycle = std::min(scheduler.GetTimestampNow() - window.timestamp_init, (u64)1024U);
+  const uint x = (uint)(cycle + 3U) >> 2;
+
+  if(x > window.x_begin) {
+    AdvanceWindow(x);
   }
 
-  window.timestamp_last_sync = timestamp_now;
+  window.dirty = true;
 }
 
 } // namespace nba::core
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <cstdio>
+#include <nba/log.hpp>
+#include <nba/rom/backup/backup_file.hpp>
+
+#ifdef _WIN32
+  #include <io.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace nba {
+
+static bool WriteAndSync(fs::path const& path, u8 const* data, size_t size) {
+#ifdef _WIN32
+  std::FILE* file = _wfopen(path.c_str(), L"wb");
+#else
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+#endif
+
+  if(file == nullptr) {
+    return false;
+  }
+
+  bool success = std::fwrite(data, 1, size, file) == size && std::fflush(file) == 0;
+
+#ifdef _WIN32
+  success = success && _commit(_fileno(file)) == 0;
+#else
+  success = success && fsync(fileno(file)) == 0;
+#endif
+
+  return std::fclose(file) == 0 && success;
+}
+
+static void SyncDirectory(fs::path const& path) {
+#ifndef _WIN32
+  const int fd = open(path.empty() ? "." : path.c_str(), O_RDONLY);
+
+  if(fd != -1) {
+    fsync(fd);
+    close(fd);
+  }
+#endif
+}
+
+bool BackupFile::Flush() {
+  if(!dirty) {
+    return true;
+  }
+
+  auto temp_path = save_path;
+  temp_path += ".tmp";
+
+  const auto Fail = [&](std::string const& message) {
+    // A failed flush is retried periodically, so only the first of consecutive failures is reported.
+    if(!flush_failed) {
+      Log<Error>("BackupFile: {}", message);
+      flush_failed = true;
+    }
+
+    std::error_code error;
+    fs::remove(temp_path, error);
+    return false;
+  };
+
+  if(!WriteAndSync(temp_path, memory.get(), file_size)) {
+    return Fail("unable to write file: " + temp_path.string());
+  }
+
+  std::error_code error;
+  fs::rename(temp_path, save_path, error);
+
+  if(error) {
+    return Fail("unable to replace file: " + save_path.string() + " (" + error.message() + ")");
+  }
+
+  // The rename is only durable once the directory entry is written as well.
+  SyncDirectory(save_path.parent_path());
+
+  if(flush_failed) {
+    Log<Info>("BackupFile: wrote file: {}", save_path.string());
+    flush_failed = false;
+  }
+
+  dirty = false;
+  return true;
+}
+
+} // namespace nba
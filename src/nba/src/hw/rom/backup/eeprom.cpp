@@ -22,7 +22,7 @@ EEPROM::EEPROM(fs::path const& save_path, Size size_hint, core::Scheduler& sched
     : size(size_hint)
     , save_path(save_path)
     , scheduler(scheduler) {
-  scheduler.Register(Scheduler::EventClass::EEPROM_ready, this, &EEPROM::OnReadyAfterWrite);
+  scheduler.Register<&EEPROM::OnReadyAfterWrite>(Scheduler::EventClass::EEPROM_ready, this);
   
   Reset();
 }
@@ -40,7 +40,9 @@ void EEPROM::Reset() {
   }
 
   int bytes = g_save_size[size];
-  
+
+  // Write back pending changes before the file is read again.
+  Flush();
   file = BackupFile::OpenOrCreate(save_path, {512, 8192}, bytes);
 
   if(bytes == g_save_size[0]) {
@@ -157,11 +159,18 @@ void EEPROM::SetSizeHint(Size size) {
     detect_size = false;
 
     if(file->Size() != bytes) {
+      Flush();
       file = BackupFile::OpenOrCreate(save_path, {(size_t)bytes}, bytes);
     }
   }
 }
 
+void EEPROM::Flush() {
+  if(file) {
+    file->Flush();
+  }
+}
+
 void EEPROM::OnReadyAfterWrite() {
   state = STATE_ACCEPT_COMMAND;
 }
@@ -26,7 +26,9 @@ void FLASH::Reset() {
   enable_select = false;
   
   int bytes = g_save_size[size];
-  
+
+  // Write back pending changes before the file is read again.
+  Flush();
   file = BackupFile::OpenOrCreate(save_path, { 65536, 131072 }, bytes);
   if(bytes == g_save_size[0]) {
     size = SIZE_64K;
@@ -128,6 +130,12 @@ void FLASH::HandleCommand(u32 address, u8 value) {
   }
 }
 
+void FLASH::Flush() {
+  if(file) {
+    file->Flush();
+  }
+}
+
 void FLASH::HandleExtended(u32 address, u8 value) {
   if(enable_write) {
     file->Write(Physical(address & 0xFFFF), value);
@@ -18,7 +18,7 @@ void EEPROM::LoadState(SaveState const& state) {
   serial_buffer = state.backup.eeprom.serial_buffer;
   transmitted_bits = state.backup.eeprom.transmitted_bits;
 
-  std::memcpy(file->Buffer(), state.backup.data, file->Size());
+  file->MemoryCopy(0, state.backup.data, file->Size());
 }
 
 void EEPROM::CopyState(SaveState& state) {
@@ -38,7 +38,7 @@ void FLASH::LoadState(SaveState const& state) {
   enable_write = state.backup.flash.enable_write;
   enable_select = state.backup.flash.enable_select;
 
-  std::memcpy(file->Buffer(), state.backup.data, file->Size());
+  file->MemoryCopy(0, state.backup.data, file->Size());
 }
 
 void FLASH::CopyState(SaveState& state) {
@@ -53,7 +53,7 @@ void FLASH::CopyState(SaveState& state) {
 }
 
 void SRAM::LoadState(SaveState const& state) {
-  std::memcpy(file->Buffer(), state.backup.data, file->Size());
+  file->MemoryCopy(0, state.backup.data, file->Size());
 }
 
 void SRAM::CopyState(SaveState& state) {
@@ -16,6 +16,9 @@ SRAM::SRAM(fs::path const& save_path)
 
 void SRAM::Reset() {
   int bytes = 32768;
+
+  // Write back pending changes before the file is read again.
+  Flush();
   file = BackupFile::OpenOrCreate(save_path, { 32768 }, bytes);
 }
 
@@ -27,4 +30,10 @@ void SRAM::Write(u32 address, u8 value) {
   file->Write(address & 0x7FFF, value);
 }
 
+void SRAM::Flush() {
+  if(file) {
+    file->Flush();
+  }
+}
+
 } // namespace nba
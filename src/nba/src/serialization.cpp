@@ -22,6 +22,8 @@ void Core::LoadState(SaveState const& state) {
   timer.LoadState(state);
   dma.LoadState(state);
   keypad.LoadState(state);
+
+  ResetIdleLoopDetection();
 }
 
 void Core::CopyState(SaveState& state) {
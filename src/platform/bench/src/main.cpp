@@ -0,0 +1,433 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fmt/format.h>
+#include <memory>
+#include <nba/core.hpp>
+#include <nba/log.hpp>
+#include <platform/loader/bios.hpp>
+#include <platform/loader/rom.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+  #include <process.h>
+#else
+  #include <unistd.h>
+#endif
+
+#include "micro/micro.hpp"
+
+namespace fs = std::filesystem;
+
+using namespace nba;
+
+static constexpr int kCyclesPerSecond = 16777216;
+
+struct Options {
+  fs::path bios_path;
+  fs::path rom_path;
+  fs::path save_path;
+  int frames = 3600;
+  int warmup_frames = 60;
+  int frame_skip = 0;
+  bool skip_bios = false;
+  bool mp2k_hle = false;
+  bool skip_idle_loops = true;
+  bool hle_bios = false;
+  bool scanline_renderer = false;
+  bool threaded_renderer = false;
+  bool compare_renderers = false;
+  bool json = false;
+  bool help = false;
+  std::string micro;
+};
+
+struct Result {
+  u64 cycles;
+  int frames;
+  double seconds;
+};
+
+static void PrintUsage(char const* app_name) {
+  fmt::print(
+    "usage: {0} [options] <bios> <rom>\n"
+    "       {0} [options] --micro <name>\n"
+    "\n"
+    "options:\n"
+    "  --frames <n>   number of frames to measure (default: 3600)\n"
+    "  --warmup <n>   number of frames to run before measuring (default: 60)\n"
+    "  --save <path>  path of the save file (default: temporary file)\n"
+    "  --frame-skip <n>\n"
+    "                 skip drawing <n> frames after each frame that is drawn\n"
+    "  --skip-bios    skip the BIOS boot screen\n"
+    "  --mp2k-hle     enable MP2K HLE audio mixer\n"
+    "  --no-idle-skip do not fast-forward idle loops\n"
+    "  --hle-bios     execute common BIOS functions natively, falls back to\n"
+    "                 a built-in replacement BIOS if <bios> cannot be loaded\n"
+    "  --scanline-renderer\n"
+    "                 draw whole scanlines instead of emulating the PPU cycle by cycle\n"
+    "  --threaded-renderer\n"
+    "                 draw the scanlines on a separate thread, implies --scanline-renderer\n"
+    "  --compare-renderers\n"
+    "                 run the scanline renderer next to the cycle renderer\n"
+    "                 and compare the hashes of every frame, with --threaded-renderer\n"
+    "                 compare the threaded to the single-threaded scanline renderer\n"
+    "  --json         print results as a single JSON object\n"
+    "  --micro <name> run a microbenchmark instead of a ROM\n"
+    "                 (scheduler, color, color-scalar, resampler-cosine,\n"
+    "                 resampler-cubic, resampler-sinc32, resampler-sinc64,\n"
+    "                 resampler-sinc128, resampler-sinc256)\n"
+    "  -h, --help     print this message\n",
+    app_name
+  );
+}
+
+static bool ParseInt(char const* value, int& result) {
+  char* end;
+  long number = std::strtol(value, &end, 10);
+
+  if(*value == '\0' || *end != '\0' || number < 0 || number > 0x7FFFFFFF) {
+    return false;
+  }
+  result = (int)number;
+  return true;
+}
+
+static bool ParseOptions(int argc, char** argv, Options& options) {
+  int positional = 0;
+
+  for(int i = 1; i < argc; i++) {
+    const auto arg = std::string_view{argv[i]};
+    const bool has_value = i + 1 < argc;
+
+    if(arg == "--help" || arg == "-h") {
+      options.help = true;
+      return true;
+    }
+
+    if(arg == "--frames" && has_value) {
+      if(!ParseInt(argv[++i], options.frames)) return false;
+    } else if(arg == "--warmup" && has_value) {
+      if(!ParseInt(argv[++i], options.warmup_frames)) return false;
+    } else if(arg == "--frame-skip" && has_value) {
+      if(!ParseInt(argv[++i], options.frame_skip)) return false;
+    } else if(arg == "--save" && has_value) {
+      options.save_path = argv[++i];
+    } else if(arg == "--skip-bios") {
+      options.skip_bios = true;
+    } else if(arg == "--mp2k-hle") {
+      options.mp2k_hle = true;
+    } else if(arg == "--no-idle-skip") {
+      options.skip_idle_loops = false;
+    } else if(arg == "--hle-bios") {
+      options.hle_bios = true;
+    } else if(arg == "--scanline-renderer") {
+      options.scanline_renderer = true;
+    } else if(arg == "--threaded-renderer") {
+      options.scanline_renderer = true;
+      options.threaded_renderer = true;
+    } else if(arg == "--compare-renderers") {
+      options.compare_renderers = true;
+    } else if(arg == "--json") {
+      options.json = true;
+    } else if(arg == "--micro" && has_value) {
+      options.micro = argv[++i];
+    } else if(arg.size() > 0 && arg[0] != '-') {
+      switch(positional++) {
+        case 0: options.bios_path = argv[i]; break;
+        case 1: options.rom_path = argv[i]; break;
+        default: return false;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  if(!options.micro.empty()) {
+    return positional == 0;
+  }
+  return positional == 2;
+}
+
+static auto Run(CoreBase& core, int frames) -> Result {
+  const u64 timestamp_start = core.GetScheduler().GetTimestampNow();
+  const auto time_start = std::chrono::steady_clock::now();
+
+  for(int i = 0; i < frames; i++) {
+    core.RunForOneFrame();
+  }
+
+  const auto time_end = std::chrono::steady_clock::now();
+  const u64 timestamp_end = core.GetScheduler().GetTimestampNow();
+
+  return Result{
+    timestamp_end - timestamp_start,
+    frames,
+    std::chrono::duration<double>(time_end - time_start).count()
+  };
+}
+
+static void PrintResult(Options const& options, Result const& result) {
+  const double cycles_per_second = result.seconds > 0 ? result.cycles / result.seconds : 0;
+  const double frames_per_second = result.seconds > 0 ? result.frames / result.seconds : 0;
+  const double speed = cycles_per_second / kCyclesPerSecond;
+
+  if(options.json) {
+    const auto Escape = [](fs::path const& path) {
+      std::string escaped;
+      for(char c : path.string()) {
+        if(c == '"' || c == '\\') {
+          escaped += '\\';
+          escaped += c;
+        } else if((unsigned char)c < 0x20) {
+          escaped += fmt::format("\\u{:04x}", c);
+        } else {
+          escaped += c;
+        }
+      }
+      return escaped;
+    };
+
+    fmt::print(
+      "{{\"rom\": \"{}\", \"frames\": {}, \"cycles\": {}, \"seconds\": {:.6f}, "
+      "\"cycles_per_second\": {:.0f}, \"frames_per_second\": {:.3f}, \"speed\": {:.4f}}}\n",
+      Escape(options.rom_path), result.frames, result.cycles, result.seconds,
+      cycles_per_second, frames_per_second, speed
+    );
+  } else {
+    fmt::print("frames:       {}\n", result.frames);
+    fmt::print("cycles:       {}\n", result.cycles);
+    fmt::print("time:         {:.3f} s\n", result.seconds);
+    fmt::print("cycles/sec:   {:.0f}\n", cycles_per_second);
+    fmt::print("frames/sec:   {:.3f}\n", frames_per_second);
+    fmt::print("speed:        {:.2f}x\n", speed);
+  }
+}
+
+static void PrintMicroResult(Options const& options, MicroResult const& result) {
+  const double per_second = result.seconds > 0 ? result.iterations / result.seconds : 0;
+
+  if(options.json) {
+    fmt::print(
+      "{{\"micro\": \"{}\", \"{}\": {}, \"seconds\": {:.6f}, \"{}_per_second\": {:.0f}}}\n",
+      result.name, result.unit, result.iterations, result.seconds, result.unit, per_second
+    );
+  } else {
+    fmt::print("{}:\n", result.name);
+    fmt::print("  {}: {}\n", result.unit, result.iterations);
+    fmt::print("  time: {:.3f} s\n", result.seconds);
+    fmt::print("  {}/sec: {:.0f}\n", result.unit, per_second);
+  }
+}
+
+static auto LoadCore(
+  Options const& options,
+  fs::path const& save_path,
+  std::shared_ptr<VideoDevice> video_dev = std::make_shared<NullVideoDevice>()
+) -> std::unique_ptr<CoreBase> {
+  auto config = std::make_shared<Config>();
+  config->skip_bios = options.skip_bios;
+  config->audio.mp2k_hle_enable = options.mp2k_hle;
+  config->skip_idle_loops = options.skip_idle_loops;
+  config->hle_bios = options.hle_bios;
+  config->scanline_renderer = options.scanline_renderer;
+  config->threaded_renderer = options.threaded_renderer;
+  config->frame_skip = options.frame_skip;
+  config->video_dev = video_dev;
+
+  auto core = CreateCore(config);
+
+  if(BIOSLoader::Load(core, options.bios_path) != BIOSLoader::Result::Success) {
+    if(!options.hle_bios) {
+      Log<Error>("Bench: failed to load BIOS from: {}", options.bios_path.string());
+      return nullptr;
+    }
+    Log<Warn>("Bench: failed to load BIOS from: {}, using the built-in BIOS", options.bios_path.string());
+  }
+
+  if(ROMLoader::Load(core, options.rom_path, save_path) != ROMLoader::Result::Success) {
+    Log<Error>("Bench: failed to load ROM from: {}", options.rom_path.string());
+    return nullptr;
+  }
+
+  core->Reset();
+  return core;
+}
+
+static int GetProcessID() {
+#ifdef _WIN32
+  return _getpid();
+#else
+  return (int)getpid();
+#endif
+}
+
+/* Removes the file when it goes out of scope.
+ * The core writes the save file when it is destroyed, so this must outlive the core that uses the file.
+ */
+struct TemporaryFile {
+  explicit TemporaryFile(fs::path path) : path(std::move(path)) {
+    fs::remove(this->path);
+  }
+
+ ~TemporaryFile() {
+    std::error_code error;
+    fs::remove(path, error);
+  }
+
+  TemporaryFile(TemporaryFile const&) = delete;
+
+  fs::path path;
+};
+
+// Both cores of a comparison must start from the same save data, but cannot share the save file.
+static void CopySaveFile(Options const& options, TemporaryFile const& copy) {
+  if(fs::exists(options.save_path)) {
+    fs::copy_file(options.save_path, copy.path);
+  }
+}
+
+// Keeps only a hash of the last frame, which is enough to compare the output of two cores.
+struct FrameHashVideoDevice final : VideoDevice {
+  void Draw(u32* buffer, FrameInfo const& info) final {
+    frames++;
+
+    if(info.unchanged) {
+      return;
+    }
+
+    u64 hash = 0xCBF29CE484222325ULL; // FNV-1a
+
+    for(int i = 0; i < 240 * 160; i++) {
+      hash = (hash ^ buffer[i]) * 0x100000001B3ULL;
+    }
+
+    last_hash = hash;
+  }
+
+  u64 last_hash = 0;
+  int frames = 0;
+};
+
+/* Runs the scanline renderer next to the cycle renderer and compares the hashes of all frames.
+ * The scanline renderer does not emulate the PPU's memory access timing, so the CPU timing
+ * and eventually the game state of both cores can drift apart, especially in games
+ * which update VRAM, PRAM or OAM during H-draw.
+ * With --threaded-renderer the threaded renderer is compared to the single-threaded scanline renderer instead,
+ * whose frames must be bit-identical.
+ */
+static int RunRendererComparison(Options const& options) {
+  const TemporaryFile save_copy{fs::path{options.save_path} += ".scanline"};
+
+  CopySaveFile(options, save_copy);
+
+  auto reference_options = options;
+  auto test_options = options;
+
+  reference_options.scanline_renderer = options.threaded_renderer;
+  reference_options.threaded_renderer = false;
+  test_options.scanline_renderer = true;
+
+  auto reference_video = std::make_shared<FrameHashVideoDevice>();
+  auto test_video = std::make_shared<FrameHashVideoDevice>();
+
+  auto reference = LoadCore(reference_options, options.save_path, reference_video);
+  auto test = LoadCore(test_options, save_copy.path, test_video);
+
+  if(!reference || !test) {
+    return EXIT_FAILURE;
+  }
+
+  int mismatches = 0;
+
+  for(int i = 0; i < options.frames; i++) {
+    reference->RunForOneFrame();
+    test->RunForOneFrame();
+
+    if(reference_video->frames != test_video->frames || reference_video->last_hash != test_video->last_hash) {
+      if(mismatches++ == 0) {
+        fmt::print("compare: first difference in frame {} (0x{:016X} vs 0x{:016X})\n", i, reference_video->last_hash, test_video->last_hash);
+      }
+    }
+  }
+
+  fmt::print("compare: {} of {} frames differ\n", mismatches, options.frames);
+  return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int RunMicroBenchmark(Options const& options) {
+  const std::pair<std::string_view, MicroResult (*)()> benchmarks[] {
+    { "scheduler", RunSchedulerBenchmark },
+    { "color", RunColorBenchmark },
+    { "color-scalar", RunColorScalarBenchmark },
+    { "mmio-dma", RunMMIODMABenchmark },
+    { "resampler-cosine", RunCosineResamplerBenchmark },
+    { "resampler-cubic", RunCubicResamplerBenchmark },
+    { "resampler-sinc32", RunSinc32ResamplerBenchmark },
+    { "resampler-sinc64", RunSinc64ResamplerBenchmark },
+    { "resampler-sinc128", RunSinc128ResamplerBenchmark },
+    { "resampler-sinc256", RunSinc256ResamplerBenchmark }
+  };
+
+  for(auto const& [name, function] : benchmarks) {
+    if(name == options.micro) {
+      PrintMicroResult(options, function());
+      return EXIT_SUCCESS;
+    }
+  }
+
+  Log<Error>("Bench: unknown microbenchmark: {}", options.micro);
+  return EXIT_FAILURE;
+}
+
+int main(int argc, char** argv) {
+  auto options = Options{};
+
+  if(!ParseOptions(argc, argv, options)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if(options.help) {
+    PrintUsage(argv[0]);
+    return EXIT_SUCCESS;
+  }
+
+  if(!options.micro.empty()) {
+    return RunMicroBenchmark(options);
+  }
+
+  std::optional<TemporaryFile> temporary_save;
+
+  if(options.save_path.empty()) {
+    // Do not touch the game's real save file and always start from a blank save.
+    // Each process uses its own file, so that concurrent runs cannot affect each other.
+    temporary_save.emplace(fs::temp_directory_path() / fmt::format("nba-bench-{}.sav", GetProcessID()));
+    options.save_path = temporary_save->path;
+  }
+
+  if(options.compare_renderers) {
+    return RunRendererComparison(options);
+  }
+
+  auto core = LoadCore(options, options.save_path);
+
+  if(!core) {
+    return EXIT_FAILURE;
+  }
+
+  Run(*core, options.warmup_frames);
+  PrintResult(options, Run(*core, options.frames));
+  return EXIT_SUCCESS;
+}
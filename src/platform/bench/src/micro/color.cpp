@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <nba/common/color.hpp>
+#include <random>
+#include <vector>
+
+#include "micro/micro.hpp"
+
+namespace nba {
+
+/* Runs the color effect and RGB555 to ARGB8888 stages of the PPU's scanline renderer
+ * on a frame of random colors, with a random mix of color effects.
+ */
+template<bool vectorized>
+static auto RunColorBenchmarkImpl(char const* name) -> MicroResult {
+  static constexpr int kWidth = 240;
+  static constexpr int kHeight = 160;
+  static constexpr int kFrames = 3600;
+
+  std::mt19937 rng{0};
+
+  std::vector<u16> colors_a(kWidth * kHeight);
+  std::vector<u16> colors_b(kWidth * kHeight);
+  std::vector<ColorEffect> effects(kWidth * kHeight);
+  std::vector<u32> output(kWidth * kHeight);
+
+  for(int i = 0; i < kWidth * kHeight; i++) {
+    colors_a[i] = (u16)rng();
+    colors_b[i] = (u16)rng();
+    effects[i] = (ColorEffect)(rng() & 3U);
+  }
+
+  const auto time_start = std::chrono::steady_clock::now();
+
+  for(int frame = 0; frame < kFrames; frame++) {
+    const int eva = frame % 17;
+    const int evb = 16 - eva;
+    const int evy = frame % 17;
+
+    for(int y = 0; y < kHeight; y++) {
+      const int offset = y * kWidth;
+
+      u16 line[kWidth];
+
+      std::memcpy(line, &colors_a[offset], sizeof(line));
+
+      if constexpr(vectorized) {
+        ApplyColorEffects(line, &colors_b[offset], &effects[offset], kWidth, eva, evb, evy);
+        ConvertRGB555ToARGB8888(&output[offset], line, kWidth);
+      } else {
+        ApplyColorEffectsScalar(line, &colors_b[offset], &effects[offset], kWidth, eva, evb, evy);
+        ConvertRGB555ToARGB8888Scalar(&output[offset], line, kWidth);
+      }
+    }
+  }
+
+  const auto time_end = std::chrono::steady_clock::now();
+
+  // Make sure that the output is not optimized away.
+  u32 checksum = 0;
+
+  for(u32 color : output) {
+    checksum ^= color;
+  }
+
+  volatile u32 sink = checksum;
+  (void)sink;
+
+  return MicroResult{
+    name,
+    "pixels",
+    (u64)kFrames * kWidth * kHeight,
+    std::chrono::duration<double>(time_end - time_start).count()
+  };
+}
+
+auto RunColorBenchmark() -> MicroResult {
+  return RunColorBenchmarkImpl<true>("color");
+}
+
+auto RunColorScalarBenchmark() -> MicroResult {
+  return RunColorBenchmarkImpl<false>("color-scalar");
+}
+
+} // namespace nba
@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <nba/integer.hpp>
+#include <string>
+
+namespace nba {
+
+struct MicroResult {
+  std::string name;
+  std::string unit;
+  u64 iterations;
+  double seconds;
+};
+
+auto RunSchedulerBenchmark() -> MicroResult;
+auto RunColorBenchmark() -> MicroResult;
+auto RunColorScalarBenchmark() -> MicroResult;
+auto RunMMIODMABenchmark() -> MicroResult;
+auto RunCosineResamplerBenchmark() -> MicroResult;
+auto RunCubicResamplerBenchmark() -> MicroResult;
+auto RunSinc32ResamplerBenchmark() -> MicroResult;
+auto RunSinc64ResamplerBenchmark() -> MicroResult;
+auto RunSinc128ResamplerBenchmark() -> MicroResult;
+auto RunSinc256ResamplerBenchmark() -> MicroResult;
+
+} // namespace nba
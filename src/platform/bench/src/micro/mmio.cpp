@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <chrono>
+#include <nba/common/punning.hpp>
+#include <nba/core.hpp>
+#include <nba/rom/rom.hpp>
+#include <vector>
+
+#include "micro/micro.hpp"
+
+namespace nba {
+
+/* A ROM which keeps restarting a 32-bit DMA3 transfer of 18 words into 0x04000010 - 0x04000057,
+ * like games do to update the background scroll, affine, window and blending registers.
+ * The DMA writes every halfword of BGxHOFS/VOFS, BG2/3 PA-PD/X/Y, WINxH/V, WININ/WINOUT, MOSAIC, BLDCNT, BLDALPHA and BLDY,
+ * and the CPU writes DMA3SAD, DMA3DAD and DMA3CNT with a single STM.
+ */
+static auto CreateMMIODMAROM() -> std::vector<u8> {
+  static constexpr u32 kCode[] {
+    0xE59F0018, // ldr r0, =0x040000D4
+    0xE59F1018, // ldr r1, =0x08000100
+    0xE59F2018, // ldr r2, =0x04000010
+    0xE59F3018, // ldr r3, =0x84000012 (enable, 32-bit, immediate, 18 words)
+    0xE880000E, // loop: stmia r0, {r1, r2, r3}
+    0xEAFFFFFD, // b loop
+    0xE1A00000, // nop
+    0xE1A00000, // nop
+    0x040000D4,
+    0x08000100,
+    0x04000010,
+    0x84000012
+  };
+
+  std::vector<u8> rom(0x200);
+
+  for(u32 i = 0; i < sizeof(kCode) / sizeof(u32); i++) {
+    write<u32>(rom.data(), i * sizeof(u32), kCode[i]);
+  }
+
+  for(u32 i = 0; i < 18; i++) {
+    write<u32>(rom.data(), 0x100 + i * sizeof(u32), 0x01230123 * (i + 1));
+  }
+
+  return rom;
+}
+
+auto RunMMIODMABenchmark() -> MicroResult {
+  // Ten seconds of emulated time, run one frame at a time.
+  static constexpr u64 kCycles = 16777216ULL * 10;
+  static constexpr int kCyclesPerFrame = 280896;
+
+  auto config = std::make_shared<Config>();
+  config->skip_bios = true;
+  config->hle_bios = true;
+  config->skip_idle_loops = false;
+
+  // The scanline renderer does little work per cycle, so that the measurement is not dominated by the PPU.
+  config->scanline_renderer = true;
+
+  auto core = CreateCore(config);
+
+  core->Attach(ROM{CreateMMIODMAROM(), nullptr, nullptr});
+  core->Reset();
+
+  const auto time_start = std::chrono::steady_clock::now();
+
+  for(u64 cycles = 0; cycles < kCycles; cycles += kCyclesPerFrame) {
+    core->Run(kCyclesPerFrame);
+  }
+
+  const auto time_end = std::chrono::steady_clock::now();
+
+  return MicroResult{
+    "mmio-dma",
+    "cycles",
+    kCycles,
+    std::chrono::duration<double>(time_end - time_start).count()
+  };
+}
+
+} // namespace nba
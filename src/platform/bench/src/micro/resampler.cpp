@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <chrono>
+#include <memory>
+#include <nba/common/dsp/resampler/cosine.hpp>
+#include <nba/common/dsp/resampler/cubic.hpp>
+#include <nba/common/dsp/resampler/sinc.hpp>
+#include <random>
+#include <vector>
+
+#include "micro/micro.hpp"
+
+namespace nba {
+
+// Sums up the output, so that the resampler's work is not optimized away.
+struct ChecksumStream final : WriteStream<StereoSample<float>> {
+  void Write(StereoSample<float> const& value) final {
+    sum += value;
+  }
+
+  StereoSample<float> sum;
+};
+
+/* Resamples one minute of random audio from the APU's default sample rate of 32768 Hz to 48000 Hz,
+ * like the APU does with the audio device's sample rate.
+ */
+template<typename Resampler>
+static auto RunResamplerBenchmarkImpl(char const* name) -> MicroResult {
+  static constexpr int kSampleRateIn = 32768;
+  static constexpr int kSampleRateOut = 48000;
+  static constexpr int kSeconds = 60;
+
+  std::mt19937 rng{0};
+  std::uniform_real_distribution<float> distribution{-1, 1};
+
+  std::vector<StereoSample<float>> input(kSampleRateIn);
+
+  for(auto& sample : input) {
+    sample = { distribution(rng), distribution(rng) };
+  }
+
+  auto output = std::make_shared<ChecksumStream>();
+  auto resampler = std::make_unique<Resampler>(output);
+
+  resampler->SetSampleRates(kSampleRateIn, kSampleRateOut);
+
+  const auto time_start = std::chrono::steady_clock::now();
+
+  for(int second = 0; second < kSeconds; second++) {
+    for(auto const& sample : input) {
+      resampler->Write(sample);
+    }
+  }
+
+  const auto time_end = std::chrono::steady_clock::now();
+
+  volatile float sink = output->sum.left + output->sum.right;
+  (void)sink;
+
+  return MicroResult{
+    name,
+    "samples",
+    (u64)kSeconds * kSampleRateIn,
+    std::chrono::duration<double>(time_end - time_start).count()
+  };
+}
+
+auto RunCosineResamplerBenchmark() -> MicroResult {
+  return RunResamplerBenchmarkImpl<CosineStereoResampler<float>>("resampler-cosine");
+}
+
+auto RunCubicResamplerBenchmark() -> MicroResult {
+  return RunResamplerBenchmarkImpl<CubicStereoResampler<float>>("resampler-cubic");
+}
+
+auto RunSinc32ResamplerBenchmark() -> MicroResult {
+  return RunResamplerBenchmarkImpl<SincStereoResampler<float, 32>>("resampler-sinc32");
+}
+
+auto RunSinc64ResamplerBenchmark() -> MicroResult {
+  return RunResamplerBenchmarkImpl<SincStereoResampler<float, 64>>("resampler-sinc64");
+}
+
+auto RunSinc128ResamplerBenchmark() -> MicroResult {
+  return RunResamplerBenchmarkImpl<SincStereoResampler<float, 128>>("resampler-sinc128");
+}
+
+auto RunSinc256ResamplerBenchmark() -> MicroResult {
+  return RunResamplerBenchmarkImpl<SincStereoResampler<float, 256>>("resampler-sinc256");
+}
+
+} // namespace nba
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <chrono>
+#include <memory>
+#include <nba/scheduler.hpp>
+
+#include "micro/micro.hpp"
+
+namespace nba {
+
+using core::Scheduler;
+
+/* Mimics the event load of a running core: the four PSG channels, four timers,
+ * the audio mixer and sequencer and the PPU all reschedule themselves continuously.
+ */
+struct SchedulerBenchmarkDevice {
+  SchedulerBenchmarkDevice(Scheduler& scheduler) : scheduler(scheduler) {
+    for(int i = 0; i < 4; i++) {
+      const auto event_class = (Scheduler::EventClass)((int)Scheduler::EventClass::APU_PSG1_generate + i);
+
+      scheduler.Register<&SchedulerBenchmarkDevice::OnPSG>(event_class, this);
+      scheduler.Add(kPSGInterval[i], event_class, 0, i);
+      scheduler.Add(kTimerInterval[i], Scheduler::EventClass::TM_overflow, 0, i);
+    }
+
+    scheduler.Register<&SchedulerBenchmarkDevice::OnTimer>(Scheduler::EventClass::TM_overflow, this);
+    scheduler.Register<&SchedulerBenchmarkDevice::OnMixer>(Scheduler::EventClass::APU_mixer, this);
+    scheduler.Register<&SchedulerBenchmarkDevice::OnSequencer>(Scheduler::EventClass::APU_sequencer, this);
+    scheduler.Register<&SchedulerBenchmarkDevice::OnPPU>(Scheduler::EventClass::PPU_hdraw_vdraw, this);
+
+    scheduler.Add(kMixerInterval, Scheduler::EventClass::APU_mixer);
+    scheduler.Add(kSequencerInterval, Scheduler::EventClass::APU_sequencer);
+    scheduler.Add(kPPUInterval, Scheduler::EventClass::PPU_hdraw_vdraw);
+  }
+
+  void OnPSG(u64 channel) {
+    const auto event_class = (Scheduler::EventClass)((int)Scheduler::EventClass::APU_PSG1_generate + channel);
+
+    event_count++;
+    scheduler.Add(kPSGInterval[channel], event_class, 0, channel);
+  }
+
+  void OnTimer(u64 id) {
+    event_count++;
+    scheduler.Add(kTimerInterval[id], Scheduler::EventClass::TM_overflow, 0, id);
+  }
+
+  void OnMixer() {
+    event_count++;
+    scheduler.Add(kMixerInterval, Scheduler::EventClass::APU_mixer);
+  }
+
+  void OnSequencer() {
+    event_count++;
+    scheduler.Add(kSequencerInterval, Scheduler::EventClass::APU_sequencer);
+  }
+
+  void OnPPU() {
+    event_count++;
+    scheduler.Add(kPPUInterval, Scheduler::EventClass::PPU_hdraw_vdraw);
+  }
+
+  static constexpr int kPSGInterval[4] { 16, 24, 32, 80 };
+  static constexpr int kTimerInterval[4] { 37, 256, 1024, 65536 };
+  static constexpr int kMixerInterval = 512;
+  static constexpr int kSequencerInterval = 32768;
+  static constexpr int kPPUInterval = 1232;
+
+  Scheduler& scheduler;
+  u64 event_count = 0;
+};
+
+auto RunSchedulerBenchmark() -> MicroResult {
+  // One minute of emulated time, consumed in CPU-sized chunks.
+  static constexpr u64 kCycles = 16777216ULL * 60;
+  static constexpr int kCyclesPerStep = 3;
+
+  auto scheduler = std::make_unique<Scheduler>();
+  auto device = std::make_unique<SchedulerBenchmarkDevice>(*scheduler);
+
+  const auto time_start = std::chrono::steady_clock::now();
+
+  while(scheduler->GetTimestampNow() < kCycles) {
+    scheduler->AddCycles(kCyclesPerStep);
+  }
+
+  const auto time_end = std::chrono::steady_clock::now();
+
+  return MicroResult{
+    "scheduler",
+    "events",
+    device->event_count,
+    std::chrono::duration<double>(time_end - time_start).count()
+  };
+}
+
+} // namespace nba
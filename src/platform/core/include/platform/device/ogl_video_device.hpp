@@ -24,7 +24,7 @@ struct OGLVideoDevice : VideoDevice {
   void Initialize();
   void SetViewport(int x, int y, int width, int height);
   void SetDefaultFBO(GLuint fbo);
-  void Draw(u32* buffer) override;
+  void Draw(u32* buffer, FrameInfo const& info) override;
   void ReloadConfig();
 
 private:
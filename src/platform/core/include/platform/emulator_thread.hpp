@@ -8,6 +8,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <nba/core.hpp>
 #include <nba/integer.hpp>
@@ -39,7 +40,8 @@ struct EmulatorThread {
 private:
   enum class MessageType : u8 {
     Reset,
-    SetKeyStatus
+    SetKeyStatus,
+    FlushBackup
   };
 
   struct Message {
@@ -55,6 +57,7 @@ private:
   void PushMessage(const Message& message);
   void ProcessMessages();
   void ProcessMessage(const Message& message);
+  void FlushBackup();
 
   static constexpr int k_number_of_input_subframes = 4;
   static constexpr int k_cycles_per_second = 16777216;
@@ -63,6 +66,9 @@ private:
 
   static_assert(k_cycles_per_frame % k_number_of_input_subframes == 0);
 
+  // Interval in which changes to the save data are written back to the save file.
+  static constexpr std::chrono::seconds k_backup_flush_interval{1};
+
   std::queue<Message> msg_queue;
   std::mutex msg_queue_mutex;
 
@@ -71,6 +77,7 @@ private:
   std::thread thread;
   std::atomic_bool running = false;
   bool paused = false;
+  std::chrono::steady_clock::time_point backup_flush_time;
   std::function<void(float)> frame_rate_cb = [](float) {};
   std::function<void()> per_frame_cb = []() {};
 };
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <nba/device/video_device.hpp>
+#include <nba/integer.hpp>
+
+namespace nba {
+
+/* Passes frames from the emulator thread to the GUI thread with three buffers:
+ * the emulator thread writes the back buffer, the GUI thread reads the front buffer
+ * and the newest complete frame waits in the middle buffer. Handing a frame over
+ * swaps buffer indices atomically, so neither thread ever blocks on the other.
+ */
+struct FrameMailbox {
+  struct Frame {
+    u32 data[240 * 160];
+    VideoDevice::FrameInfo info;
+  };
+
+  // Called by the emulator thread.
+  void Write(u32 const* buffer, VideoDevice::FrameInfo const& info);
+
+  // Called by the GUI thread. Returns the newest complete frame or nullptr if no frame was written yet.
+  auto Read() -> Frame*;
+
+  // Called by the GUI thread. Returns true if a frame was written since the last call to Read().
+  bool HasNewFrame() const {
+    return middle.load(std::memory_order_relaxed) & k_fresh;
+  }
+
+  // Discards all frames. Must not be called while the emulator thread is running.
+  void Reset();
+
+private:
+  static constexpr u8 k_fresh = 4U;
+
+  Frame frames[3];
+
+  int back = 0;
+  int front = 1;
+  std::atomic<u8> middle = 2U;
+
+  bool has_front_frame = false;
+};
+
+} // namespace nba
@@ -35,6 +35,8 @@ void PlatformConfig::Load(std::string const& path) {
       auto general = general_result.unwrap();
       this->bios_path = toml::find_or<std::string>(general, "bios_path", "bios.bin");
       this->skip_bios = toml::find_or<toml::boolean>(general, "bios_skip", false);
+      this->skip_idle_loops = toml::find_or<toml::boolean>(general, "skip_idle_loops", true);
+      this->hle_bios = toml::find_or<toml::boolean>(general, "hle_bios", false);
       this->save_folder = toml::find_or<std::string>(general, "save_folder", "");
     }
   }
@@ -104,6 +106,9 @@ void PlatformConfig::Load(std::string const& path) {
       }
 
       this->video.lcd_ghosting = toml::find_or<bool>(video, "lcd_ghosting", true);
+      this->scanline_renderer = toml::find_or<toml::boolean>(video, "scanline_renderer", false);
+      this->threaded_renderer = toml::find_or<toml::boolean>(video, "threaded_renderer", false);
+      this->frame_skip = toml::find_or<int>(video, "frame_skip", 0);
     }
   }
 
@@ -156,6 +161,8 @@ void PlatformConfig::Save(std::string const& path) {
   // General
   data["general"]["bios_path"] = this->bios_path;
   data["general"]["bios_skip"] = this->skip_bios;
+  data["general"]["skip_idle_loops"] = this->skip_idle_loops;
+  data["general"]["hle_bios"] = this->hle_bios;
   data["general"]["save_folder"] = this->save_folder;
 
   // Cartridge
@@ -195,6 +202,9 @@ void PlatformConfig::Save(std::string const& path) {
   data["video"]["filter"] = filter;
   data["video"]["color_correction"] = color_correction;
   data["video"]["lcd_ghosting"] = this->video.lcd_ghosting;
+  data["video"]["scanline_renderer"] = this->scanline_renderer;
+  data["video"]["threaded_renderer"] = this->threaded_renderer;
+  data["video"]["frame_skip"] = this->frame_skip;
 
   // Audio
   std::string resampler;
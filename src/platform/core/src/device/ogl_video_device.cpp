@@ -310,7 +310,7 @@ void OGLVideoDevice::SetDefaultFBO(GLuint fbo) {
   default_fbo = fbo;
 }
 
-void OGLVideoDevice::Draw(u32* buffer) {
+void OGLVideoDevice::Draw(u32* buffer, FrameInfo const&) {
   // Update and bind LCD screen texture
   glActiveTexture(GL_TEXTURE0);
   glBindTexture(GL_TEXTURE_2D, textures[input_index]);
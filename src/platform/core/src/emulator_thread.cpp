@@ -28,6 +28,11 @@ bool EmulatorThread::IsPaused() const {
 
 void EmulatorThread::SetPause(bool value) {
   paused = value;
+
+  // The emulator may be paused for a long time (or closed while paused), so write the save file right away.
+  if(value) {
+    PushMessage({.type = MessageType::FlushBackup});
+  }
 }
 
 bool EmulatorThread::GetFastForward() const {
@@ -54,6 +59,7 @@ void EmulatorThread::Start(std::unique_ptr<CoreBase> core) {
 
   thread = std::thread{[this]() {
     frame_limiter.Reset();
+    backup_flush_time = std::chrono::steady_clock::now() + k_backup_flush_interval;
 
     while(running.load()) {
       ProcessMessages();
@@ -71,10 +77,18 @@ void EmulatorThread::Start(std::unique_ptr<CoreBase> core) {
         }
         frame_rate_cb(real_fps);
       });
+
+      /* Also applies while paused, so that a save file which cannot be written
+       * is retried once per interval rather than on every iteration.
+       */
+      if(std::chrono::steady_clock::now() >= backup_flush_time) {
+        FlushBackup();
+      }
     }
 
     // Make sure all messages are handled before exiting
     ProcessMessages();
+    FlushBackup();
   }};
 }
 
@@ -137,8 +151,17 @@ void EmulatorThread::ProcessMessage(const Message& message) {
       core->SetKeyStatus(message.set_key_status.key, message.set_key_status.pressed);
       break;
     }
+    case MessageType::FlushBackup: {
+      FlushBackup();
+      break;
+    }
     default: Assert(false, "unhandled message type: {}", (int)message.type);
   }
 }
 
+void EmulatorThread::FlushBackup() {
+  core->GetROM().FlushBackup();
+  backup_flush_time = std::chrono::steady_clock::now() + k_backup_flush_interval;
+}
+
 } // namespace nba
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <cstring>
+#include <platform/frame_mailbox.hpp>
+
+namespace nba {
+
+void FrameMailbox::Write(u32 const* buffer, VideoDevice::FrameInfo const& info) {
+  auto& frame = frames[back];
+
+  std::memcpy(frame.data, buffer, sizeof(frame.data));
+  frame.info = info;
+
+  back = middle.exchange((u8)back | k_fresh, std::memory_order_acq_rel) & 3U;
+}
+
+auto FrameMailbox::Read() -> Frame* {
+  if(middle.load(std::memory_order_relaxed) & k_fresh) {
+    front = middle.exchange((u8)front, std::memory_order_acq_rel) & 3U;
+    has_front_frame = true;
+  }
+
+  return has_front_frame ? &frames[front] : nullptr;
+}
+
+void FrameMailbox::Reset() {
+  back = 0;
+  front = 1;
+  middle = 2U;
+  has_front_frame = false;
+}
+
+} // namespace nba
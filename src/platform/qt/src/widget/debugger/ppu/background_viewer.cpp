@@ -277,6 +277,10 @@ bool BackgroundViewer::eventFilter(QObject* object, QEvent* event) {
 void BackgroundViewer::DrawBackgroundMode0() {
   const u16 bgcnt = m_core->PeekHalfIO(0x04000008 + (m_bg_id << 1));
 
+  m_tile_cache.Update(m_vram);
+
+  nba::TileCache& tile_cache = m_tile_cache.GetTileCache();
+
   const int screens_x = 1 + ((bgcnt >> 14) & 1);
   const int screens_y = 1 + (bgcnt >> 15);
 
@@ -307,44 +311,36 @@ void BackgroundViewer::DrawBackgroundMode0() {
           meta_data.flip_h = flip_x > 0;
 
           if(use_8bpp) {
-            u32 tile_address = tile_base + (tile_number << 6);
+            const u32 tile_address = tile_base + (tile_number << 6);
+            const u8* tile_data = tile_cache.GetTile8BPP(tile_address);
 
             meta_data.tile_address = tile_address;
             meta_data.palette = 0;
 
             for(int tile_y = 0; tile_y < 8; tile_y++) {
-              u64 data = nba::read<u64>(m_vram, tile_address);
-
               const int image_y = screen_y << 8 | y << 3 | tile_y ^ flip_y;
 
               for(int tile_x = 0; tile_x < 8; tile_x++) {
                 const int image_x = screen_x << 8 | x << 3 | tile_x ^ flip_x;
 
-                m_image_rgb565[image_y * 1024 + image_x] = m_pram[(u8)data];
-                data >>= 8;
+                m_image_rgb565[image_y * 1024 + image_x] = m_pram[*tile_data++];
               }
-
-              tile_address += sizeof(u64);
             }
           } else {
-            u32 tile_address = tile_base + (tile_number << 5);
+            const u32 tile_address = tile_base + (tile_number << 5);
+            const u8* tile_data = tile_cache.GetTile4BPP(tile_address);
 
             meta_data.tile_address = tile_address;
             meta_data.palette = palette;
 
             for(int tile_y = 0; tile_y < 8; tile_y++) {
-              u32 data = nba::read<u32>(m_vram, tile_address);
-
               const int image_y = screen_y << 8 | y << 3 | tile_y ^ flip_y;
 
               for(int tile_x = 0; tile_x < 8; tile_x++) {
                 const int image_x = screen_x << 8 | x << 3 | tile_x ^ flip_x;
 
-                m_image_rgb565[image_y * 1024 + image_x] = m_pram[(palette << 4) | (data & 15)];
-                data >>= 4;
+                m_image_rgb565[image_y * 1024 + image_x] = m_pram[(palette << 4) | *tile_data++];
               }
-
-              tile_address += sizeof(u32);
             }
           }
         }
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <nba/core.hpp>
+#include <nba/tile_cache.hpp>
 #include <QCheckBox>
 #include <QImage>
 #include <QLabel>
@@ -90,6 +91,7 @@ class BackgroundViewer : public QWidget {
     nba::CoreBase* m_core;
     u16* m_pram;
     u8*  m_vram;
+    nba::TileCacheSnapshot m_tile_cache;
 
     Q_OBJECT
 };
\ No newline at end of file
@@ -148,6 +148,10 @@ void SpriteViewer::Update() {
 
   u32* const buffer = (u32*)m_image_rgb32.bits();
 
+  m_tile_cache.Update(m_vram);
+
+  nba::TileCache& tile_cache = m_tile_cache.GetTileCache();
+
   if(is_8bpp) {
     const u16* palette = &m_pram[256];
 
@@ -163,19 +167,14 @@ void SpriteViewer::Update() {
 
         // @todo: handle bad tile numbers and overflows and the likes
 
-        u32 tile_address = 0x10000u + (current_tile_number << 5);
+        const u8* tile_data = tile_cache.GetTile8BPP(0x10000u + (current_tile_number << 5));
 
         for(int y = 0; y < 8; y++) {
-          u64 tile_data = nba::read<u64>(m_vram, tile_address);
-
           u32* dst = &buffer[tile_y << 9 | y << 6 | tile_x << 3];
 
           for(int x = 0; x < 8; x++) {
-            *dst++ = Rgb565ToArgb8888(palette[tile_data & 255u]);
-            tile_data >>= 8;
+            *dst++ = Rgb565ToArgb8888(palette[*tile_data++]);
           }
-
-          tile_address += sizeof(u64);
         }
       }
     }
@@ -194,19 +193,14 @@ void SpriteViewer::Update() {
 
         // @todo: handle bad tile numbers and overflows and the likes
 
-        u32 tile_address = 0x10000u + (current_tile_number << 5);
+        const u8* tile_data = tile_cache.GetTile4BPP(0x10000u + (current_tile_number << 5));
 
         for(int y = 0; y < 8; y++) {
-          u32 tile_data = nba::read<u32>(m_vram, tile_address);
-
           u32* dst = &buffer[tile_y << 9 | y << 6 | tile_x << 3];
 
           for(int x = 0; x < 8; x++) {
-            *dst++ = Rgb565ToArgb8888(palette[tile_data & 15u]);
-            tile_data >>= 4;
+            *dst++ = Rgb565ToArgb8888(palette[*tile_data++]);
           }
-
-          tile_address += sizeof(u32);
         }
       }
     }
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <nba/core.hpp>
+#include <nba/tile_cache.hpp>
 #include <QCheckBox>
 #include <QGroupBox>
 #include <QImage>
@@ -60,6 +61,7 @@ class SpriteViewer : public QWidget {
     u16* m_pram;
     u8* m_vram;
     u8* m_oam;
+    nba::TileCacheSnapshot m_tile_cache;
 
     Q_OBJECT
 };
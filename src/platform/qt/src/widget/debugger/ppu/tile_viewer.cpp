@@ -227,6 +227,10 @@ void TileViewer::UpdateImpl() {
   const int magnification = m_spin_magnification->value();
   const int palette_offset = m_tile_base == 0x10000u ? 256 : 0;
 
+  m_tile_cache.Update(m_vram);
+
+  nba::TileCache& tile_cache = m_tile_cache.GetTileCache();
+
   u16* const image_rgb565 = m_image_rgb565; 
   u32* const image_rgb32  = (u32*)m_image_rgb32.bits();
 
@@ -240,20 +244,19 @@ void TileViewer::UpdateImpl() {
       const int m_tile_base_x = (tile % 32) * 8;
       const int m_tile_base_y = (tile / 32) * 8;
 
-      for(int y = 0; y < 8; y++) {
-        u64 tile_row_data = nba::read<u64>(m_vram, tile_address);
+      const u8* tile_data = tile_cache.GetTile8BPP(tile_address);
 
+      for(int y = 0; y < 8; y++) {
         for(int x = 0; x < 8; x++) {
           const size_t index = (m_tile_base_y + y) * 256 + m_tile_base_x + x;
-          const u16 color_rgb565 = palette[(u8)tile_row_data];
+          const u16 color_rgb565 = palette[*tile_data++];
 
           image_rgb565[index] = color_rgb565;
           image_rgb32[index] = Rgb565ToArgb8888(color_rgb565);
-          tile_row_data >>= 8;
         }
-
-        tile_address += sizeof(u64);
       }
+
+      tile_address += 64;
     }
 
     height /= 2;
@@ -264,20 +267,19 @@ void TileViewer::UpdateImpl() {
       const int m_tile_base_x = (tile % 32) * 8;
       const int m_tile_base_y = (tile / 32) * 8;
 
-      for(int y = 0; y < 8; y++) {
-        u32 tile_row_data = nba::read<u32>(m_vram, tile_address);
+      const u8* tile_data = tile_cache.GetTile4BPP(tile_address);
 
+      for(int y = 0; y < 8; y++) {
         for(int x = 0; x < 8; x++) {
           const size_t index = (m_tile_base_y + y) * 256 + m_tile_base_x + x;
-          const u16 color_rgb565 = palette[tile_row_data & 15];
+          const u16 color_rgb565 = palette[*tile_data++];
 
           image_rgb565[index] = color_rgb565;
           image_rgb32[index] = Rgb565ToArgb8888(color_rgb565);
-          tile_row_data >>= 4;
         }
-
-        tile_address += sizeof(u32);
       }
+
+      tile_address += 32;
     }
   }
 
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <nba/core.hpp>
+#include <nba/tile_cache.hpp>
 #include <QCheckBox>
 #include <QLabel>
 #include <QPaintEvent>
@@ -57,6 +58,7 @@ class TileViewer : public QWidget {
 
     u8*  m_vram;
     u16* m_pram;
+    nba::TileCacheSnapshot m_tile_cache;
 
     Q_OBJECT
 };
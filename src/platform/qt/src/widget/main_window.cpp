@@ -188,6 +188,15 @@ void MainWindow::CreateVideoMenu(QMenu* parent) {
   }, &config->video.color, false, reload_config);
 
   CreateBooleanOption(menu, "LCD ghosting", &config->video.lcd_ghosting, false, reload_config);
+  CreateBooleanOption(menu, "Scanline renderer (faster, less accurate)", &config->scanline_renderer, true);
+  CreateBooleanOption(menu, "Draw scanlines on a separate thread", &config->threaded_renderer, true);
+
+  CreateSelectionOption(menu->addMenu("Frame skip"), {
+    { "Off", 0 },
+    { "1",   1 },
+    { "2",   2 },
+    { "3",   3 }
+  }, &config->frame_skip, false);
 }
 
 void MainWindow::CreateAudioMenu(QMenu* parent) {
@@ -236,6 +245,7 @@ void MainWindow::CreateSystemMenu(QMenu* parent) {
   });
 
   CreateBooleanOption(menu, "Skip BIOS", &config->skip_bios);
+  CreateBooleanOption(menu, "HLE BIOS functions", &config->hle_bios);
 
   menu->addSeparator();
 
@@ -719,7 +729,7 @@ void MainWindow::Stop() {
     config->audio_dev->Close();
 
     // Clear the screen.
-    screen->Draw(nullptr);
+    screen->Clear();
 
     // Clear the list of save state slots:
     game_loaded = false;
@@ -769,6 +779,11 @@ void MainWindow::LoadROM(std::u16string const& path) {
 
     switch(nba::BIOSLoader::Load(core, QString::fromStdString(config->bios_path).toStdU16String())) {
       case nba::BIOSLoader::Result::CannotFindFile: {
+        // The HLE BIOS brings its own replacement for the BIOS.
+        if(config->hle_bios) {
+          break;
+        }
+
         QMessageBox box {this};
         box.setText(tr("A Game Boy Advance BIOS file is required but cannot be located.\n\nWould you like to add one now?"));
         box.setIcon(QMessageBox::Question);
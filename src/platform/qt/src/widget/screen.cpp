@@ -62,8 +62,19 @@ bool Screen::Initialize() {
   return true;
 }
 
-void Screen::Draw(u32* buffer) {
-  emit RequestDraw(buffer);
+void Screen::Draw(u32* buffer, FrameInfo const& info) {
+  // An unchanged frame looks the same on screen, unless LCD ghosting blends it with the previous frames.
+  if(!info.unchanged || config->video.lcd_ghosting) {
+    // The emulator thread keeps drawing into the buffer while the GUI thread renders the frame.
+    frame_mailbox.Write(buffer, info);
+  }
+
+  emit RequestDraw();
+}
+
+void Screen::Clear() {
+  frame_mailbox.Reset();
+  update();
 }
 
 void Screen::ReloadConfig() {
@@ -72,9 +83,10 @@ void Screen::ReloadConfig() {
   UpdateViewport();
 }
 
-void Screen::OnRequestDraw(u32* buffer) {
-  this->buffer = buffer;
-  update();
+void Screen::OnRequestDraw() {
+  if(frame_mailbox.HasNewFrame()) {
+    update();
+  }
 }
 
 void Screen::paintEvent([[maybe_unused]] QPaintEvent* event) {
@@ -93,9 +105,11 @@ void Screen::Render() {
   context->makeCurrent(this->windowHandle());
   glClear(GL_COLOR_BUFFER_BIT);
 
-  if(buffer) {
+  auto frame = frame_mailbox.Read();
+
+  if(frame) {
     ogl_video_device.SetDefaultFBO(context->defaultFramebufferObject());
-    ogl_video_device.Draw(buffer);
+    ogl_video_device.Draw(frame->data, frame->info);
   }
 
   context->swapBuffers(this->windowHandle());
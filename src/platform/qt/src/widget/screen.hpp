@@ -8,6 +8,7 @@
 #pragma once
 
 #include <platform/device/ogl_video_device.hpp>
+#include <platform/frame_mailbox.hpp>
 #include <QOpenGLContext>
 #include <QWidget>
 
@@ -20,15 +21,16 @@ struct Screen : QWidget, nba::VideoDevice {
   );
 
   bool Initialize();
-  void Draw(u32* buffer) final;
+  void Draw(u32* buffer, FrameInfo const& info) final;
+  void Clear();
   void ReloadConfig();
   QPaintEngine* paintEngine() const override { return nullptr; }; // Silence Qt.
 
 signals:
-  void RequestDraw(u32* buffer);
+  void RequestDraw();
 
 private slots:
-  void OnRequestDraw(u32* buffer);
+  void OnRequestDraw();
 
 protected:
   void paintEvent(QPaintEvent* event) override;
@@ -42,7 +44,7 @@ private:
   void Render();
   void UpdateViewport();
 
-  u32* buffer = nullptr;
+  nba::FrameMailbox frame_mailbox;
   QOpenGLContext* context = nullptr;
   nba::OGLVideoDevice ogl_video_device;
   std::shared_ptr<QtConfig> config;